@@ -0,0 +1,192 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// Аллокатор по умолчанию для ArrayPtr и SimpleVector.
+// Берёт память у malloc (aligned_alloc для типов с повышенным выравниванием)
+// и умеет расширять блок на месте через realloc
+template <typename Type>
+class MallocAllocator {
+public:
+    using value_type = Type;
+    using is_always_equal = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    MallocAllocator() noexcept = default;
+
+    template <typename Other>
+    MallocAllocator(const MallocAllocator<Other>&) noexcept {
+    }
+
+    // Выделяет сырую память под size элементов
+    [[nodiscard]] Type* allocate(size_t size) {
+        void* ptr = nullptr;
+        if constexpr (alignof(Type) <= alignof(std::max_align_t)) {
+            ptr = std::malloc(Bytes(size));
+        }
+        else {
+            // aligned_alloc требует размер, кратный выравниванию
+            size_t bytes = (Bytes(size) + alignof(Type) - 1) / alignof(Type) * alignof(Type);
+            ptr = std::aligned_alloc(alignof(Type), bytes);
+        }
+        if (ptr == nullptr) {
+            throw std::bad_alloc();
+        }
+        return static_cast<Type*>(ptr);
+    }
+
+    void deallocate(Type* ptr, size_t) noexcept {
+        std::free(static_cast<void*>(ptr));
+    }
+
+    // Изменяет размер блока с old_size до new_size элементов, по возможности на месте.
+    // Содержимое переносится побайтно
+    [[nodiscard]] Type* reallocate(Type* ptr, size_t old_size, size_t new_size) {
+        if constexpr (alignof(Type) <= alignof(std::max_align_t)) {
+            void* new_ptr = std::realloc(static_cast<void*>(ptr), Bytes(new_size));
+            if (new_ptr == nullptr) {
+                throw std::bad_alloc();
+            }
+            return static_cast<Type*>(new_ptr);
+        }
+        else {
+            // realloc не сохраняет повышенное выравнивание
+            Type* new_ptr = allocate(new_size);
+            if (ptr != nullptr) {
+                std::memcpy(static_cast<void*>(new_ptr), static_cast<const void*>(ptr), std::min(old_size, new_size) * sizeof(Type));
+            }
+            deallocate(ptr, old_size);
+            return new_ptr;
+        }
+    }
+
+private:
+    static size_t Bytes(size_t size) {
+        if (size > std::numeric_limits<size_t>::max() / sizeof(Type)) {
+            throw std::bad_array_new_length();
+        }
+        return size * sizeof(Type);
+    }
+};
+
+template <typename Type, typename Other>
+bool operator==(const MallocAllocator<Type>&, const MallocAllocator<Other>&) noexcept {
+    return true;
+}
+
+template <typename Type, typename Other>
+bool operator!=(const MallocAllocator<Type>&, const MallocAllocator<Other>&) noexcept {
+    return false;
+}
+
+// Аллокатор с выравниванием начала блока на Alignment байт (или alignof(Type), если оно больше).
+// Размер блока округляется вверх до кратного PadBytes, поэтому за последним элементом
+// до этой границы всегда есть выделенная память: SIMD-цикл может обрабатывать вектор
+// целыми регистрами шириной до PadBytes без отдельной обработки хвоста (см. PaddedSize).
+// realloc не сохраняет выравнивание, поэтому метода reallocate нет и блок при росте копируется
+template <typename Type, size_t Alignment, size_t PadBytes = Alignment>
+class AlignedAllocator {
+public:
+    static_assert(std::has_single_bit(Alignment), "alignment must be a power of two");
+    static_assert(std::has_single_bit(PadBytes), "padding must be a power of two");
+
+    using value_type = Type;
+    using is_always_equal = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    template <typename Other>
+    struct rebind {
+        using other = AlignedAllocator<Other, Alignment, PadBytes>;
+    };
+
+    // Фактическое выравнивание блока
+    static constexpr size_t kAlignment = std::max({Alignment, alignof(Type), alignof(void*)});
+    // Размер блока кратен kBlockBytes; aligned_alloc требует кратности выравниванию
+    static constexpr size_t kBlockBytes = std::max(kAlignment, PadBytes);
+
+    AlignedAllocator() noexcept = default;
+
+    template <typename Other>
+    AlignedAllocator(const AlignedAllocator<Other, Alignment, PadBytes>&) noexcept {
+    }
+
+    [[nodiscard]] Type* allocate(size_t size) {
+        void* ptr = std::aligned_alloc(kAlignment, BlockBytes(size));
+        if (ptr == nullptr) {
+            throw std::bad_alloc();
+        }
+        return static_cast<Type*>(ptr);
+    }
+
+    void deallocate(Type* ptr, size_t) noexcept {
+        std::free(static_cast<void*>(ptr));
+    }
+
+    // Число элементов, под которые гарантированно выделена память в блоке из size элементов
+    static constexpr size_t PaddedSize(size_t size) noexcept {
+        return (size * sizeof(Type) + kBlockBytes - 1) / kBlockBytes * kBlockBytes / sizeof(Type);
+    }
+
+private:
+    static size_t BlockBytes(size_t size) {
+        if (size > (std::numeric_limits<size_t>::max() - kBlockBytes) / sizeof(Type)) {
+            throw std::bad_array_new_length();
+        }
+        return std::max<size_t>((size * sizeof(Type) + kBlockBytes - 1) / kBlockBytes, 1) * kBlockBytes;
+    }
+};
+
+template <typename Type, typename Other, size_t Alignment, size_t PadBytes>
+bool operator==(const AlignedAllocator<Type, Alignment, PadBytes>&, const AlignedAllocator<Other, Alignment, PadBytes>&) noexcept {
+    return true;
+}
+
+template <typename Type, typename Other, size_t Alignment, size_t PadBytes>
+bool operator!=(const AlignedAllocator<Type, Alignment, PadBytes>&, const AlignedAllocator<Other, Alignment, PadBytes>&) noexcept {
+    return false;
+}
+
+// Краткая запись выровненного аллокатора в параметрах вектора: SimpleVector<float, Align<64>>
+// берёт память у AlignedAllocator<float, 64>
+template <size_t Alignment, size_t PadBytes = Alignment>
+struct Align {
+};
+
+// Аллокатор для элементов Type по параметру вектора: Align<...> раскрывается в AlignedAllocator,
+// остальные аллокаторы используются как есть
+template <typename Type, typename Allocator>
+struct ResolveAllocator {
+    using type = Allocator;
+};
+
+template <typename Type, size_t Alignment, size_t PadBytes>
+struct ResolveAllocator<Type, Align<Alignment, PadBytes>> {
+    using type = AlignedAllocator<Type, Alignment, PadBytes>;
+};
+
+template <typename Type, typename Allocator>
+using resolve_allocator_t = typename ResolveAllocator<Type, Allocator>::type;
+
+// Сообщает, умеет ли аллокатор изменять размер блока методом reallocate(ptr, old_size, new_size)
+template <typename Allocator, typename = void>
+struct HasReallocate : std::false_type {
+};
+
+template <typename Allocator>
+struct HasReallocate<Allocator, std::void_t<decltype(std::declval<Allocator&>().reallocate(
+    std::declval<typename Allocator::value_type*>(), size_t{}, size_t{}))>> : std::true_type {
+};
+
+template <typename Allocator>
+inline constexpr bool has_reallocate_v = HasReallocate<Allocator>::value;
@@ -2,15 +2,39 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cstddef>
 #include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+#include <utility>
 
+#include "allocator.h"
 
-template <typename Type>
+// Тег для выделения памяти под элементы без их конструирования
+struct RawMemoryTag {
+};
+
+// Сырая память (RawMemoryTag) выделяется и освобождается аллокатором Allocator.
+// Массивы, созданные конструктором ArrayPtr(size) или переданные указателем, освобождаются через delete[].
+// Чужой буфер можно передать вместе с функцией освобождения (deleter): он считается сырой памятью,
+// а при разрушении или переезде в новую память освобождается этой функцией.
+// Deleter размером с указатель (функция, пустой объект, лямбда с одним указателем) хранится внутри ArrayPtr,
+// больший — в отдельном блоке в куче
+template <typename Type, typename Allocator = MallocAllocator<Type>>
 class ArrayPtr {
 public:
+    using AllocTraits = std::allocator_traits<Allocator>;
+
     // Инициализирует ArrayPtr нулевым указателем
     ArrayPtr() = default;
 
+    // Инициализирует ArrayPtr нулевым указателем, сохраняя аллокатор для сырой памяти
+    explicit ArrayPtr(const Allocator& alloc) noexcept
+        : free_(nullptr)
+        , alloc_(alloc) {
+    }
+
     // Создаёт в куче массив из size элементов типа Type.
     // Если size == 0, поле raw_ptr_ должно быть равно nullptr
     explicit ArrayPtr(size_t size) {
@@ -19,7 +43,58 @@ public:
         }
         else {
             raw_ptr_ = std::move(new Type[size]);
+            raw_size_ = size;
+        }
+    }
+
+    // Выделяет сырую память под size элементов типа Type, не конструируя их.
+    // Конструирование и разрушение элементов берёт на себя владелец ArrayPtr
+    ArrayPtr(size_t size, RawMemoryTag, const Allocator& alloc = Allocator())
+        : free_(nullptr)
+        , alloc_(alloc) {
+        if (size != 0) {
+            raw_ptr_ = AllocTraits::allocate(alloc_, size);
+            raw_size_ = size;
+        }
+    }
+
+    // Забирает сырую память ptr под size элементов, выделенную аллокатором alloc
+    ArrayPtr(Type* ptr, size_t size, RawMemoryTag, const Allocator& alloc = Allocator()) noexcept
+        : raw_ptr_(ptr)
+        , raw_size_(ptr != nullptr ? size : 0)
+        , free_(nullptr)
+        , alloc_(alloc) {
+    }
+
+    // Забирает чужой буфер ptr под size элементов; память освобождается вызовом deleter(ptr)
+    // или deleter(ptr, size). Для nullptr deleter не вызывается.
+    // Если не удалось сохранить deleter, буфер освобождается им сразу и исключение пробрасывается
+    template <typename Deleter>
+        requires std::is_invocable_v<Deleter&, Type*> || std::is_invocable_v<Deleter&, Type*, size_t>
+    ArrayPtr(Type* ptr, size_t size, Deleter deleter, const Allocator& alloc = Allocator())
+        : free_(nullptr)
+        , alloc_(alloc) {
+        if (ptr == nullptr) {
+            return;
         }
+        if constexpr (is_inline_deleter_v<Deleter>) {
+            new (deleter_storage_) Deleter(std::move(deleter));
+        }
+        else {
+            Deleter* boxed;
+            try {
+                // new выделяет память до того, как deleter перемещён, поэтому при ошибке он ещё цел
+                boxed = new Deleter(std::move(deleter));
+            }
+            catch (...) {
+                InvokeDeleter(deleter, ptr, size);
+                throw;
+            }
+            std::memcpy(deleter_storage_, &boxed, sizeof(boxed));
+        }
+        free_ = &FreeExternal<Deleter>;
+        raw_ptr_ = ptr;
+        raw_size_ = size;
     }
 
     // Конструктор из сырого указателя, хранящего адрес массива в куче либо nullptr
@@ -30,18 +105,55 @@ public:
     // Запрещаем копирование
     ArrayPtr(const ArrayPtr&) = delete;
 
+    // Забирает массив у other вместе с его аллокатором
+    ArrayPtr(ArrayPtr&& other) noexcept
+        : raw_ptr_(std::exchange(other.raw_ptr_, nullptr))
+        , raw_size_(std::exchange(other.raw_size_, 0))
+        , free_(other.TakeFree())
+        , alloc_(std::move(other.alloc_)) {
+        std::memcpy(deleter_storage_, other.deleter_storage_, sizeof(deleter_storage_));
+    }
+
     ~ArrayPtr() {
-        delete[]  raw_ptr_;
+        Free();
     }
 
     // Запрещаем присваивание
     ArrayPtr& operator=(const ArrayPtr&) = delete;
 
+    // Освобождает свой массив и забирает массив other.
+    // Аллокатор переходит вместе с массивом, если это разрешает propagate_on_container_move_assignment,
+    // иначе аллокаторы должны быть равны
+    ArrayPtr& operator=(ArrayPtr&& other) noexcept {
+        if (this != &other) {
+            Free();
+            if constexpr (AllocTraits::propagate_on_container_move_assignment::value) {
+                alloc_ = std::move(other.alloc_);
+            }
+            else {
+                assert(alloc_ == other.alloc_);
+            }
+            raw_ptr_ = std::exchange(other.raw_ptr_, nullptr);
+            raw_size_ = std::exchange(other.raw_size_, 0);
+            free_ = other.TakeFree();
+            std::memcpy(deleter_storage_, other.deleter_storage_, sizeof(deleter_storage_));
+        }
+        return *this;
+    }
+
     // Прекращает владением массивом в памяти, возвращает значение адреса массива
-    // После вызова метода указатель на массив должен обнулиться
+    // После вызова метода указатель на массив должен обнулиться.
+    // Сырую память после этого следует вернуть аллокатору из GetAllocator(),
+    // а чужой буфер — освободить тем способом, которым он был получен; deleter не вызывается
     [[nodiscard]] Type* Release() noexcept {
         Type* ptr = std::move(raw_ptr_);
         raw_ptr_ = std::move(nullptr);
+        raw_size_ = 0;
+        if (HasDeleter()) {
+            // Для nullptr функция освобождения только отпускает сохранённый deleter
+            free_(nullptr, 0, deleter_storage_);
+            free_ = nullptr;
+        }
         return ptr;
     }
 
@@ -68,11 +180,143 @@ public:
         return  std::move(raw_ptr_);
     }
 
-    // Обменивается значениям указателя на массив с объектом other
+    // Возвращает число элементов, под которые выделен массив; 0 для массива, переданного одним указателем
+    size_t GetSize() const noexcept {
+        return raw_size_;
+    }
+
+    // Возвращает аллокатор сырой памяти
+    const Allocator& GetAllocator() const noexcept {
+        return alloc_;
+    }
+
+    // Изменяет размер сырой памяти до new_size элементов, по возможности не перемещая блок.
+    // Содержимое переносится побайтно, поэтому метод годится только для тривиально перемещаемых типов.
+    // Пустой ArrayPtr при этом переходит в режим сырой памяти
+    void Reallocate(size_t new_size) {
+        assert(IsRaw() || raw_ptr_ == nullptr);
+        if (raw_ptr_ == nullptr) {
+            free_ = nullptr;
+        }
+        if (new_size == 0) {
+            Free();
+            raw_ptr_ = nullptr;
+            raw_size_ = 0;
+            return;
+        }
+        if (raw_ptr_ == nullptr) {
+            raw_ptr_ = AllocTraits::allocate(alloc_, new_size);
+        }
+        else if (HasDeleter()) {
+            // Чужой буфер нельзя расширить аллокатором: содержимое переезжает в память аллокатора
+            Type* ptr = AllocTraits::allocate(alloc_, new_size);
+            std::memcpy(static_cast<void*>(ptr), static_cast<const void*>(raw_ptr_), std::min(raw_size_, new_size) * sizeof(Type));
+            Free();
+            raw_ptr_ = ptr;
+        }
+        else if constexpr (has_reallocate_v<Allocator>) {
+            raw_ptr_ = alloc_.reallocate(raw_ptr_, raw_size_, new_size);
+        }
+        else {
+            Type* ptr = AllocTraits::allocate(alloc_, new_size);
+            std::memcpy(static_cast<void*>(ptr), static_cast<const void*>(raw_ptr_), std::min(raw_size_, new_size) * sizeof(Type));
+            AllocTraits::deallocate(alloc_, raw_ptr_, raw_size_);
+            raw_ptr_ = ptr;
+        }
+        raw_size_ = new_size;
+    }
+
+    // Возвращает true, если буфер чужой и освобождается своим deleter
+    bool HasDeleter() const noexcept {
+        return free_ != nullptr && free_ != &DeleteArray;
+    }
+
+    // Возвращает true, если память выделена без конструирования элементов
+    bool IsRaw() const noexcept {
+        return free_ != &DeleteArray;
+    }
+
+    // Обменивается значениям указателя на массив с объектом other.
+    // Аллокаторы меняются местами, если это разрешает propagate_on_container_swap, иначе должны быть равны
     void swap(ArrayPtr& other) noexcept {
         std::swap(other.raw_ptr_, raw_ptr_);
+        std::swap(other.raw_size_, raw_size_);
+        std::swap(other.free_, free_);
+        std::swap(other.deleter_storage_, deleter_storage_);
+        if constexpr (AllocTraits::propagate_on_container_swap::value) {
+            using std::swap;
+            swap(other.alloc_, alloc_);
+        }
+        else {
+            assert(alloc_ == other.alloc_);
+        }
     }
 
 private:
+    // Освобождает буфер ptr под size элементов; deleter — хранилище deleter_storage_.
+    // Режим памяти задаётся самим указателем: nullptr — сырая память аллокатора, DeleteArray — массив new[],
+    // иначе — чужой буфер со своим deleter
+    using FreeFunction = void (*)(Type* ptr, size_t size, std::byte* deleter) noexcept;
+
+    // Deleter хранится внутри ArrayPtr, если помещается в указатель и копируется побайтно
+    template <typename Deleter>
+    static constexpr bool is_inline_deleter_v = sizeof(Deleter) <= sizeof(void*) && alignof(Deleter) <= alignof(void*)
+        && std::is_trivially_copyable_v<Deleter>;
+
+    template <typename Deleter>
+    static void InvokeDeleter(Deleter& deleter, Type* ptr, size_t size) noexcept {
+        if constexpr (std::is_invocable_v<Deleter&, Type*, size_t>) {
+            deleter(ptr, size);
+        }
+        else {
+            deleter(ptr);
+        }
+    }
+
+    static void DeleteArray(Type* ptr, size_t, std::byte*) noexcept {
+        delete[] ptr;
+    }
+
+    template <typename Deleter>
+    static void FreeExternal(Type* ptr, size_t size, std::byte* storage) noexcept {
+        if constexpr (is_inline_deleter_v<Deleter>) {
+            if (ptr != nullptr) {
+                InvokeDeleter(*std::launder(reinterpret_cast<Deleter*>(storage)), ptr, size);
+            }
+        }
+        else {
+            Deleter* boxed;
+            std::memcpy(&boxed, storage, sizeof(boxed));
+            if (ptr != nullptr) {
+                InvokeDeleter(*boxed, ptr, size);
+            }
+            delete boxed;
+        }
+    }
+
     Type* raw_ptr_ = std::move(nullptr);
-};
\ No newline at end of file
+    size_t raw_size_ = 0;
+    FreeFunction free_ = &DeleteArray;
+    alignas(void*) std::byte deleter_storage_[sizeof(void*)] = {};
+    [[no_unique_address]] Allocator alloc_{};
+
+    // Отдаёт режим памяти перемещаемому массиву; у пустого источника остаётся сырая память
+    FreeFunction TakeFree() noexcept {
+        return std::exchange(free_, IsRaw() ? nullptr : &DeleteArray);
+    }
+
+    void Free() noexcept {
+        if (HasDeleter()) {
+            free_(raw_ptr_, raw_size_, deleter_storage_);
+            free_ = nullptr;
+        }
+        else if (IsRaw()) {
+            if (raw_ptr_ != nullptr) {
+                AllocTraits::deallocate(alloc_, raw_ptr_, raw_size_);
+            }
+        }
+        else {
+            delete[]  raw_ptr_;
+        }
+    }
+};
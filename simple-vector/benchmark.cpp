@@ -0,0 +1,414 @@
+// Бенчмарки SimpleVector в сравнении с std::vector.
+// Результаты печатаются в формате JSON (в stdout или в файл из --out).
+// Параметры:
+//   --quick          малые размеры и одно повторение, для проверки сборки
+//   --filter <text>  запускать только бенчмарки, в имени которых есть text
+//   --out <path>     записать JSON в файл
+#include "simple_vector.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+// Перемещаемый, но не копируемый тип, как X в тестах
+class X {
+public:
+    X()
+        : X(5) {
+    }
+    X(size_t num)
+        : x_(num) {
+    }
+    X(const X& other) = delete;
+    X& operator=(const X& other) = delete;
+    X(X&& other) noexcept {
+        x_ = exchange(other.x_, 0);
+    }
+    X& operator=(X&& other) noexcept {
+        x_ = exchange(other.x_, 0);
+        return *this;
+    }
+    size_t GetX() const {
+        return x_;
+    }
+
+private:
+    size_t x_;
+};
+
+template <typename Type>
+Type MakeValue(size_t i);
+
+template <>
+int MakeValue<int>(size_t i) {
+    return static_cast<int>(i);
+}
+
+template <>
+string MakeValue<string>(size_t i) {
+    // Строка длиннее буфера SSO, чтобы копирование обращалось к куче
+    return "benchmark-value-with-heap-storage-"s + to_string(i);
+}
+
+template <>
+X MakeValue<X>(size_t i) {
+    return X(i);
+}
+
+template <typename Type>
+string_view TypeName();
+
+template <>
+string_view TypeName<int>() {
+    return "int";
+}
+
+template <>
+string_view TypeName<string>() {
+    return "std::string";
+}
+
+template <>
+string_view TypeName<X>() {
+    return "X";
+}
+
+// Не даёт компилятору выбросить вычисление value
+template <typename Type>
+void DoNotOptimize(const Type& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "g"(&value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+// Единый интерфейс к SimpleVector и std::vector
+template <typename Type>
+struct SimpleVectorAdapter {
+    using Container = SimpleVector<Type>;
+    static constexpr string_view kName = "SimpleVector";
+
+    static void PushBack(Container& c, Type value) {
+        c.PushBack(move(value));
+    }
+    static void Insert(Container& c, size_t index, Type value) {
+        c.Insert(c.begin() + index, move(value));
+    }
+    static void Erase(Container& c, size_t index) {
+        c.Erase(c.begin() + index);
+    }
+    static void Reserve(Container& c, size_t capacity) {
+        c.Reserve(capacity);
+    }
+    static void Resize(Container& c, size_t size) {
+        c.Resize(size);
+    }
+    static size_t Size(const Container& c) {
+        return c.GetSize();
+    }
+};
+
+template <typename Type>
+struct StdVectorAdapter {
+    using Container = vector<Type>;
+    static constexpr string_view kName = "std::vector";
+
+    static void PushBack(Container& c, Type value) {
+        c.push_back(move(value));
+    }
+    static void Insert(Container& c, size_t index, Type value) {
+        c.insert(c.begin() + index, move(value));
+    }
+    static void Erase(Container& c, size_t index) {
+        c.erase(c.begin() + index);
+    }
+    static void Reserve(Container& c, size_t capacity) {
+        c.reserve(capacity);
+    }
+    static void Resize(Container& c, size_t size) {
+        c.resize(size);
+    }
+    static size_t Size(const Container& c) {
+        return c.size();
+    }
+};
+
+class Stopwatch {
+public:
+    void Start() {
+        start_ = chrono::steady_clock::now();
+    }
+    void Stop() {
+        elapsed_ += chrono::steady_clock::now() - start_;
+    }
+    int64_t GetNanoseconds() const {
+        return chrono::duration_cast<chrono::nanoseconds>(elapsed_).count();
+    }
+
+private:
+    chrono::steady_clock::time_point start_;
+    chrono::steady_clock::duration elapsed_{};
+};
+
+struct Options {
+    bool quick = false;
+    string filter;
+    string out;
+};
+
+struct Result {
+    string name;
+    string_view container;
+    string_view type;
+    size_t size = 0;
+    size_t operations = 0;
+    size_t repetitions = 0;
+    double ns_per_op_median = 0;
+    double ns_per_op_min = 0;
+};
+
+// Один прогон: подготавливает данные, замеряет через Stopwatch и возвращает число операций
+using Body = function<size_t(Stopwatch&)>;
+
+class Runner {
+public:
+    explicit Runner(Options options)
+        : options_(move(options)) {
+    }
+
+    const Options& GetOptions() const {
+        return options_;
+    }
+
+    void Run(const string& name, string_view container, string_view type, size_t size, const Body& body) {
+        if (!options_.filter.empty() && name.find(options_.filter) == string::npos) {
+            return;
+        }
+        const int64_t min_time_ns = options_.quick ? 0 : 20'000'000;
+        const size_t max_repetitions = options_.quick ? 1 : 1000;
+        // Подготовка данных не замеряется, но тоже занимает время: общий прогон ограничен
+        const auto deadline = chrono::steady_clock::now() + chrono::milliseconds(250);
+        vector<double> ns_per_op;
+        size_t operations = 0;
+        int64_t total_ns = 0;
+        do {
+            Stopwatch stopwatch;
+            operations = body(stopwatch);
+            total_ns += stopwatch.GetNanoseconds();
+            ns_per_op.push_back(static_cast<double>(stopwatch.GetNanoseconds()) / static_cast<double>(max<size_t>(operations, 1)));
+        } while (total_ns < min_time_ns && ns_per_op.size() < max_repetitions
+            && chrono::steady_clock::now() < deadline);
+
+        sort(ns_per_op.begin(), ns_per_op.end());
+        results_.push_back({name, container, type, size, operations, ns_per_op.size(),
+            ns_per_op[ns_per_op.size() / 2], ns_per_op.front()});
+    }
+
+    void WriteJson(ostream& out) const {
+        out << "{\n  \"benchmarks\": [";
+        bool first = true;
+        for (const Result& r : results_) {
+            out << (first ? "\n" : ",\n");
+            first = false;
+            out << "    {\"name\": \"" << r.name << "\", \"container\": \"" << r.container
+                << "\", \"type\": \"" << r.type << "\", \"size\": " << r.size
+                << ", \"operations\": " << r.operations << ", \"repetitions\": " << r.repetitions
+                << ", \"ns_per_op_median\": " << r.ns_per_op_median
+                << ", \"ns_per_op_min\": " << r.ns_per_op_min << "}";
+        }
+        out << "\n  ]\n}\n";
+    }
+
+private:
+    Options options_;
+    vector<Result> results_;
+};
+
+template <typename Adapter, typename Type>
+typename Adapter::Container MakeFilled(size_t size) {
+    typename Adapter::Container c;
+    Adapter::Reserve(c, size);
+    for (size_t i = 0; i < size; ++i) {
+        Adapter::PushBack(c, MakeValue<Type>(i));
+    }
+    return c;
+}
+
+template <typename Adapter, typename Type>
+void RunForSize(Runner& runner, size_t size) {
+    using Container = typename Adapter::Container;
+    const string_view container = Adapter::kName;
+    const string_view type = TypeName<Type>();
+    // Вставки и удаления в середине квадратичны, поэтому их число ограничено
+    const size_t edits = min<size_t>(size, 100);
+
+    for (bool reserve : {false, true}) {
+        runner.Run(reserve ? "PushBackReserved" : "PushBack", container, type, size, [&](Stopwatch& sw) {
+            vector<Type> values;
+            values.reserve(size);
+            for (size_t i = 0; i < size; ++i) {
+                values.push_back(MakeValue<Type>(i));
+            }
+            sw.Start();
+            Container c;
+            if (reserve) {
+                Adapter::Reserve(c, size);
+            }
+            for (Type& value : values) {
+                Adapter::PushBack(c, move(value));
+            }
+            DoNotOptimize(c);
+            sw.Stop();
+            return size;
+        });
+    }
+
+    const pair<string, size_t (*)(size_t)> positions[] = {
+        {"InsertFront", [](size_t) -> size_t { return 0; }},
+        {"InsertMiddle", [](size_t n) -> size_t { return n / 2; }},
+        {"InsertBack", [](size_t n) -> size_t { return n; }},
+    };
+    for (const auto& [name, position] : positions) {
+        runner.Run(name, container, type, size, [&](Stopwatch& sw) {
+            Container c = MakeFilled<Adapter, Type>(size);
+            sw.Start();
+            for (size_t i = 0; i < edits; ++i) {
+                Adapter::Insert(c, position(Adapter::Size(c)), MakeValue<Type>(i));
+            }
+            DoNotOptimize(c);
+            sw.Stop();
+            return edits;
+        });
+    }
+
+    runner.Run("EraseMiddle", container, type, size, [&](Stopwatch& sw) {
+        Container c = MakeFilled<Adapter, Type>(size);
+        sw.Start();
+        for (size_t i = 0; i < edits; ++i) {
+            Adapter::Erase(c, Adapter::Size(c) / 2);
+        }
+        DoNotOptimize(c);
+        sw.Stop();
+        return edits;
+    });
+
+    runner.Run("Resize", container, type, size, [&](Stopwatch& sw) {
+        sw.Start();
+        Container c;
+        Adapter::Resize(c, size);
+        DoNotOptimize(c);
+        Adapter::Resize(c, 0);
+        DoNotOptimize(c);
+        sw.Stop();
+        return size;
+    });
+
+    runner.Run("MoveConstruct", container, type, size, [&](Stopwatch& sw) {
+        Container c = MakeFilled<Adapter, Type>(size);
+        sw.Start();
+        Container moved(move(c));
+        DoNotOptimize(moved);
+        sw.Stop();
+        return size_t{1};
+    });
+
+    if constexpr (is_copy_constructible_v<Type>) {
+        runner.Run("CopyConstruct", container, type, size, [&](Stopwatch& sw) {
+            const Container c = MakeFilled<Adapter, Type>(size);
+            sw.Start();
+            Container copy(c);
+            DoNotOptimize(copy);
+            sw.Stop();
+            return size;
+        });
+
+        // Равные векторы: сравнение проходит по всем элементам
+        runner.Run("Equal", container, type, size, [&](Stopwatch& sw) {
+            const Container lhs = MakeFilled<Adapter, Type>(size);
+            const Container rhs = MakeFilled<Adapter, Type>(size);
+            sw.Start();
+            bool result = lhs == rhs;
+            DoNotOptimize(result);
+            sw.Stop();
+            return size;
+        });
+
+        runner.Run("Less", container, type, size, [&](Stopwatch& sw) {
+            const Container lhs = MakeFilled<Adapter, Type>(size);
+            const Container rhs = MakeFilled<Adapter, Type>(size);
+            sw.Start();
+            bool result = lhs < rhs;
+            DoNotOptimize(result);
+            sw.Stop();
+            return size;
+        });
+    }
+}
+
+template <typename Type>
+void RunForType(Runner& runner) {
+    const vector<size_t> sizes = runner.GetOptions().quick
+        ? vector<size_t>{16, 256}
+        : vector<size_t>{16, 1024, 65536, 1048576};
+    for (size_t size : sizes) {
+        RunForSize<SimpleVectorAdapter<Type>, Type>(runner, size);
+        RunForSize<StdVectorAdapter<Type>, Type>(runner, size);
+    }
+}
+
+Options ParseOptions(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        const string_view arg = argv[i];
+        if (arg == "--quick") {
+            options.quick = true;
+        }
+        else if (arg == "--filter" && i + 1 < argc) {
+            options.filter = argv[++i];
+        }
+        else if (arg == "--out" && i + 1 < argc) {
+            options.out = argv[++i];
+        }
+        else {
+            cerr << "Usage: " << argv[0] << " [--quick] [--filter <text>] [--out <path>]" << endl;
+            exit(2);
+        }
+    }
+    return options;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    Runner runner(ParseOptions(argc, argv));
+    RunForType<int>(runner);
+    RunForType<string>(runner);
+    RunForType<X>(runner);
+
+    if (runner.GetOptions().out.empty()) {
+        runner.WriteJson(cout);
+    }
+    else {
+        ofstream out(runner.GetOptions().out);
+        if (!out) {
+            cerr << "Cannot open " << runner.GetOptions().out << endl;
+            return 1;
+        }
+        runner.WriteJson(out);
+    }
+    return 0;
+}
@@ -0,0 +1,434 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+#include "allocator.h"
+
+// Сводка работы кэша буферов: откуда были выданы блоки
+struct BufferCacheStats {
+    // Из кэша потока, без синхронизации
+    uint64_t thread_hits = 0;
+    // Из общего пула под мьютексом
+    uint64_t global_hits = 0;
+    // Из кучи: подходящего блока в кэше не было
+    uint64_t misses = 0;
+    // Мимо кэша: блоки крупнее BufferCache::kMaxCachedBytes
+    uint64_t bypassed = 0;
+
+    // Доля запросов кэшируемого размера, обслуженных без обращения к куче
+    double GetHitRate() const noexcept {
+        const uint64_t total = thread_hits + global_hits + misses;
+        return total == 0 ? 0.0 : static_cast<double>(thread_hits + global_hits) / static_cast<double>(total);
+    }
+
+    BufferCacheStats& operator+=(const BufferCacheStats& rhs) noexcept {
+        thread_hits += rhs.thread_hits;
+        global_hits += rhs.global_hits;
+        misses += rhs.misses;
+        bypassed += rhs.bypassed;
+        return *this;
+    }
+};
+
+// Кэш освобождённых блоков памяти. Размеры от kMinCachedBytes до kMaxCachedBytes округляются
+// до степени двойки; каждый поток держит для каждого класса список свободных блоков не длиннее
+// kThreadBlocksPerClass и не больше kThreadCacheBytes в сумме. Блок, не поместившийся в кэш потока,
+// уходит в общий пул (до kGlobalBlocksPerClass блоков класса), а из него — в кучу. Промах в кэше
+// потока сначала забирает из общего пула пачку блоков и только потом обращается к malloc.
+// Блоки, освобождённые другим потоком, попадают в кэш освободившего потока.
+// При завершении потока его блоки переходят в общий пул
+class BufferCache {
+public:
+    static constexpr size_t kMinCachedBytes = 64;
+    static constexpr size_t kMaxCachedBytes = size_t{1} << 20;
+    static constexpr size_t kThreadBlocksPerClass = 8;
+    static constexpr size_t kThreadCacheBytes = size_t{4} << 20;
+    static constexpr size_t kGlobalBlocksPerClass = 64;
+
+    // Выделяет блок не меньше bytes байт, выровненный на alignof(std::max_align_t)
+    [[nodiscard]] static void* Allocate(size_t bytes) {
+        if (bytes > kMaxCachedBytes) {
+            ThreadCache* cache = Local();
+            if (cache != nullptr) {
+                Increment(cache->bypassed);
+            }
+            return HeapAllocate(bytes);
+        }
+        const size_t index = ClassIndex(bytes);
+        ThreadCache* cache = Local();
+        if (cache == nullptr) {
+            // Поток уже разрушил свой кэш (память освобождается из деструкторов thread_local)
+            void* ptr = Global().TryTake(index);
+            return ptr != nullptr ? ptr : HeapAllocate(ClassSize(index));
+        }
+        if (void* ptr = cache->Pop(index)) {
+            Increment(cache->thread_hits);
+            return ptr;
+        }
+        if (cache->Refill(index)) {
+            Increment(cache->global_hits);
+            return cache->Pop(index);
+        }
+        Increment(cache->misses);
+        return HeapAllocate(ClassSize(index));
+    }
+
+    // Возвращает блок, выделенный Allocate(bytes) с тем же bytes
+    static void Deallocate(void* ptr, size_t bytes) noexcept {
+        if (ptr == nullptr) {
+            return;
+        }
+        if (bytes > kMaxCachedBytes) {
+            std::free(ptr);
+            return;
+        }
+        const size_t index = ClassIndex(bytes);
+        ThreadCache* cache = Local();
+        if (cache == nullptr || !cache->TryPush(index, ptr)) {
+            Global().Put(index, ptr);
+        }
+    }
+
+    // Сколько байт на самом деле занимает блок, выделенный под bytes байт
+    static size_t GetBlockSize(size_t bytes) noexcept {
+        return bytes > kMaxCachedBytes ? bytes : ClassSize(ClassIndex(bytes));
+    }
+
+    // Счётчики текущего потока
+    static BufferCacheStats GetThreadStats() noexcept {
+        ThreadCache* cache = Local();
+        return cache != nullptr ? cache->GetStats() : BufferCacheStats{};
+    }
+
+    // Сумма счётчиков всех потоков, работающих и завершившихся
+    static BufferCacheStats GetStats() {
+        return Global().GetStats();
+    }
+
+    // Переносит блоки текущего потока в общий пул, например перед долгим простоем потока
+    static void ReleaseThreadCache() noexcept {
+        if (ThreadCache* cache = Local()) {
+            cache->Flush();
+        }
+    }
+
+    // Возвращает в кучу все блоки общего пула
+    static void Trim() noexcept {
+        Global().Trim();
+    }
+
+private:
+    // 64, 128, ..., 1 МиБ
+    static constexpr size_t kClassCount = std::countr_zero(kMaxCachedBytes) - std::countr_zero(kMinCachedBytes) + 1;
+
+    // Свободный блок хранит ссылку на следующий прямо в своей памяти
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    struct FreeList {
+        FreeBlock* head = nullptr;
+        size_t count = 0;
+
+        void Push(void* ptr) noexcept {
+            auto* block = static_cast<FreeBlock*>(ptr);
+            block->next = head;
+            head = block;
+            ++count;
+        }
+
+        void* Pop() noexcept {
+            FreeBlock* block = head;
+            head = block->next;
+            --count;
+            return block;
+        }
+    };
+
+    class ThreadCache;
+
+    // Общий пул и реестр кэшей потоков для сбора статистики
+    class GlobalPool {
+    public:
+        void* TryTake(size_t index) noexcept {
+            std::lock_guard guard(mutex_);
+            return lists_[index].count == 0 ? nullptr : lists_[index].Pop();
+        }
+
+        // Переносит в to до count блоков класса index; возвращает число перенесённых
+        size_t TakeBatch(size_t index, FreeList& to, size_t count) noexcept {
+            std::lock_guard guard(mutex_);
+            FreeList& from = lists_[index];
+            const size_t taken = std::min(count, from.count);
+            for (size_t i = 0; i < taken; ++i) {
+                to.Push(from.Pop());
+            }
+            return taken;
+        }
+
+        void Put(size_t index, void* ptr) noexcept {
+            {
+                std::lock_guard guard(mutex_);
+                if (lists_[index].count < kGlobalBlocksPerClass) {
+                    lists_[index].Push(ptr);
+                    return;
+                }
+            }
+            std::free(ptr);
+        }
+
+        // Переносит в пул все блоки списка; лишние освобождает
+        void PutAll(size_t index, FreeList& from) noexcept {
+            std::lock_guard guard(mutex_);
+            while (from.count > 0) {
+                void* ptr = from.Pop();
+                if (lists_[index].count < kGlobalBlocksPerClass) {
+                    lists_[index].Push(ptr);
+                }
+                else {
+                    std::free(ptr);
+                }
+            }
+        }
+
+        void Trim() noexcept {
+            std::lock_guard guard(mutex_);
+            for (FreeList& list : lists_) {
+                while (list.count > 0) {
+                    std::free(list.Pop());
+                }
+            }
+        }
+
+        void Register(ThreadCache* cache) {
+            std::lock_guard guard(mutex_);
+            threads_.push_back(cache);
+        }
+
+        void Unregister(ThreadCache* cache, const BufferCacheStats& stats) noexcept {
+            std::lock_guard guard(mutex_);
+            threads_.erase(std::find(threads_.begin(), threads_.end(), cache));
+            retired_ += stats;
+        }
+
+        BufferCacheStats GetStats() {
+            std::lock_guard guard(mutex_);
+            BufferCacheStats stats = retired_;
+            for (const ThreadCache* cache : threads_) {
+                stats += cache->GetStats();
+            }
+            return stats;
+        }
+
+    private:
+        std::mutex mutex_;
+        std::array<FreeList, kClassCount> lists_{};
+        std::vector<ThreadCache*> threads_;
+        // Счётчики завершившихся потоков
+        BufferCacheStats retired_;
+    };
+
+    class ThreadCache {
+    public:
+        // Счётчики меняет только поток-владелец; атомарны, чтобы GetStats мог читать их из других потоков
+        std::atomic<uint64_t> thread_hits{0};
+        std::atomic<uint64_t> global_hits{0};
+        std::atomic<uint64_t> misses{0};
+        std::atomic<uint64_t> bypassed{0};
+
+        ThreadCache() {
+            Global().Register(this);
+        }
+
+        ThreadCache(const ThreadCache&) = delete;
+        ThreadCache& operator=(const ThreadCache&) = delete;
+
+        ~ThreadCache() {
+            Flush();
+            Global().Unregister(this, GetStats());
+            thread_cache_destroyed_ = true;
+        }
+
+        void* Pop(size_t index) noexcept {
+            FreeList& list = lists_[index];
+            if (list.count == 0) {
+                return nullptr;
+            }
+            bytes_ -= ClassSize(index);
+            return list.Pop();
+        }
+
+        bool TryPush(size_t index, void* ptr) noexcept {
+            FreeList& list = lists_[index];
+            if (list.count == kThreadBlocksPerClass || bytes_ + ClassSize(index) > kThreadCacheBytes) {
+                return false;
+            }
+            list.Push(ptr);
+            bytes_ += ClassSize(index);
+            return true;
+        }
+
+        // Забирает из общего пула до половины лимита класса, не выходя за лимит байт потока
+        bool Refill(size_t index) noexcept {
+            const size_t budget = (kThreadCacheBytes - bytes_) / ClassSize(index);
+            const size_t wanted = std::min(std::max<size_t>(kThreadBlocksPerClass / 2, 1), budget);
+            if (wanted == 0) {
+                return false;
+            }
+            const size_t taken = Global().TakeBatch(index, lists_[index], wanted);
+            bytes_ += taken * ClassSize(index);
+            return taken > 0;
+        }
+
+        void Flush() noexcept {
+            for (size_t index = 0; index < kClassCount; ++index) {
+                Global().PutAll(index, lists_[index]);
+            }
+            bytes_ = 0;
+        }
+
+        BufferCacheStats GetStats() const noexcept {
+            BufferCacheStats stats;
+            stats.thread_hits = thread_hits.load(std::memory_order_relaxed);
+            stats.global_hits = global_hits.load(std::memory_order_relaxed);
+            stats.misses = misses.load(std::memory_order_relaxed);
+            stats.bypassed = bypassed.load(std::memory_order_relaxed);
+            return stats;
+        }
+
+    private:
+        std::array<FreeList, kClassCount> lists_{};
+        // Суммарный размер блоков в списках потока
+        size_t bytes_ = 0;
+    };
+
+    // Выставляется при разрушении кэша потока: после этого блоки идут прямо в общий пул
+    static inline thread_local bool thread_cache_destroyed_ = false;
+
+    // Пул не разрушается никогда: векторы в статических объектах могут освобождать память
+    // после того, как отработали деструкторы других статических объектов
+    static GlobalPool& Global() noexcept {
+        static GlobalPool* pool = new GlobalPool;
+        return *pool;
+    }
+
+    static ThreadCache* Local() noexcept {
+        if (thread_cache_destroyed_) {
+            return nullptr;
+        }
+        thread_local ThreadCache cache;
+        return &cache;
+    }
+
+    // Счётчик меняет только один поток, поэтому хватает загрузки и записи без атомарного сложения
+    static void Increment(std::atomic<uint64_t>& counter) noexcept {
+        counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    static size_t ClassIndex(size_t bytes) noexcept {
+        return std::countr_zero(std::bit_ceil(std::max(bytes, kMinCachedBytes))) - std::countr_zero(kMinCachedBytes);
+    }
+
+    static size_t ClassSize(size_t index) noexcept {
+        return kMinCachedBytes << index;
+    }
+
+    static void* HeapAllocate(size_t bytes) {
+        void* ptr = std::malloc(bytes);
+        if (ptr == nullptr) {
+            throw std::bad_alloc();
+        }
+        return ptr;
+    }
+};
+
+// Аллокатор, который берёт блоки из BufferCache: векторы одного размера, которые часто создаются
+// и разрушаются, после прогрева не обращаются к куче. Подключается параметром вектора:
+// SimpleVector<int, CachingAllocator<int>>. Блок округлён до класса кэша, поэтому reallocate
+// в пределах класса возвращает тот же блок. Типы с повышенным выравниванием обслуживает MallocAllocator
+template <typename Type>
+class CachingAllocator {
+public:
+    using value_type = Type;
+    using is_always_equal = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    CachingAllocator() noexcept = default;
+
+    template <typename Other>
+    CachingAllocator(const CachingAllocator<Other>&) noexcept {
+    }
+
+    [[nodiscard]] Type* allocate(size_t size) {
+        if constexpr (kOverAligned) {
+            return MallocAllocator<Type>().allocate(size);
+        }
+        else {
+            return static_cast<Type*>(BufferCache::Allocate(Bytes(size)));
+        }
+    }
+
+    void deallocate(Type* ptr, size_t size) noexcept {
+        if constexpr (kOverAligned) {
+            MallocAllocator<Type>().deallocate(ptr, size);
+        }
+        else {
+            BufferCache::Deallocate(static_cast<void*>(ptr), size * sizeof(Type));
+        }
+    }
+
+    // Изменяет размер блока с old_size до new_size элементов; содержимое переносится побайтно
+    [[nodiscard]] Type* reallocate(Type* ptr, size_t old_size, size_t new_size) {
+        if constexpr (kOverAligned) {
+            return MallocAllocator<Type>().reallocate(ptr, old_size, new_size);
+        }
+        else {
+            if (ptr == nullptr) {
+                return allocate(new_size);
+            }
+            const size_t old_bytes = old_size * sizeof(Type);
+            const size_t new_bytes = Bytes(new_size);
+            if (old_bytes <= BufferCache::kMaxCachedBytes && new_bytes <= BufferCache::kMaxCachedBytes
+                && BufferCache::GetBlockSize(old_bytes) == BufferCache::GetBlockSize(new_bytes)) {
+                return ptr;
+            }
+            Type* new_ptr = allocate(new_size);
+            std::memcpy(static_cast<void*>(new_ptr), static_cast<const void*>(ptr), std::min(old_bytes, new_bytes));
+            deallocate(ptr, old_size);
+            return new_ptr;
+        }
+    }
+
+private:
+    static constexpr bool kOverAligned = alignof(Type) > alignof(std::max_align_t);
+
+    static size_t Bytes(size_t size) {
+        if (size > std::numeric_limits<size_t>::max() / sizeof(Type)) {
+            throw std::bad_array_new_length();
+        }
+        return size * sizeof(Type);
+    }
+};
+
+template <typename Type, typename Other>
+bool operator==(const CachingAllocator<Type>&, const CachingAllocator<Other>&) noexcept {
+    return true;
+}
+
+template <typename Type, typename Other>
+bool operator!=(const CachingAllocator<Type>&, const CachingAllocator<Other>&) noexcept {
+    return false;
+}
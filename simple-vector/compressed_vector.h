@@ -0,0 +1,407 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+
+#include "simd_compare.h"
+#include "simple_vector.h"
+
+// Сжатый вектор беззнаковых целых для чтения: значения делятся на блоки по kBlockSize,
+// блок хранит первое значение и разности соседних значений, упакованные по width бит.
+// Неубывающий блок хранит разности как есть, остальные — в зигзаг-кодировке, чтобы отрицательные
+// разности тоже были короткими. Биты разностей лежат вперемешку по kLanes дорожкам: значение i
+// попадает в дорожку i % kLanes, поэтому одна строка из kLanes слов распаковывается одним 128-битным
+// регистром SSE2, и там же считаются префиксные суммы. Последние GetSize() % kBlockSize значений
+// хранятся неупакованными, пока блок не заполнится.
+// Доступ по индексу распаковывает начало блока; последовательный обход распаковывает блок целиком
+template <typename Type>
+class CompressedVector {
+public:
+    static_assert(std::is_unsigned_v<Type> && (sizeof(Type) == 4 || sizeof(Type) == 8),
+        "CompressedVector stores 32- or 64-bit unsigned integers");
+
+    static constexpr size_t kBlockSize = 128;
+    // Число слов в строке упакованного блока: 128 бит
+    static constexpr size_t kLanes = 16 / sizeof(Type);
+
+    class ConstIterator;
+    using Iterator = ConstIterator;
+
+    CompressedVector() = default;
+
+    explicit CompressedVector(std::span<const Type> values) {
+        Append(values);
+        ShrinkToFit();
+    }
+
+    CompressedVector(std::initializer_list<Type> init)
+        : CompressedVector(std::span<const Type>(init.begin(), init.size())) {
+    }
+
+    size_t GetSize() const noexcept {
+        return size_;
+    }
+
+    bool IsEmpty() const noexcept {
+        return size_ == 0;
+    }
+
+    // Число упакованных блоков; неполный последний блок в них не входит
+    size_t GetBlockCount() const noexcept {
+        return blocks_.GetSize();
+    }
+
+    // Объём памяти, занятой вектором, включая резерв
+    size_t GetMemoryUsage() const noexcept {
+        return sizeof(*this) + blocks_.GetCapacity() * sizeof(BlockHeader) + words_.GetCapacity() * sizeof(Type)
+            + tail_.GetCapacity() * sizeof(Type);
+    }
+
+    Type operator[](size_t index) const noexcept {
+        assert(index < size_);
+        const size_t block = index / kBlockSize;
+        if (block == blocks_.GetSize()) {
+            return tail_[index % kBlockSize];
+        }
+        return DecodeValue(blocks_[block], index % kBlockSize);
+    }
+
+    // Выбрасывает исключение std::out_of_range, если index >= size
+    Type At(size_t index) const {
+        if (index >= size_) {
+            throw std::out_of_range("out_of_range");
+        }
+        return (*this)[index];
+    }
+
+    void PushBack(Type value) {
+        tail_.PushBack(value);
+        ++size_;
+        if (tail_.GetSize() == kBlockSize) {
+            EncodeBlock(tail_.begin());
+            tail_.Clear();
+        }
+    }
+
+    // Дописывает значения; полные блоки упаковываются прямо из values
+    void Append(std::span<const Type> values) {
+        size_t i = 0;
+        while (!tail_.IsEmpty() && i < values.size()) {
+            PushBack(values[i++]);
+        }
+        blocks_.Reserve(blocks_.GetSize() + (values.size() - i) / kBlockSize);
+        for (; i + kBlockSize <= values.size(); i += kBlockSize) {
+            EncodeBlock(values.data() + i);
+            size_ += kBlockSize;
+        }
+        for (; i < values.size(); ++i) {
+            PushBack(values[i]);
+        }
+    }
+
+    // Распаковывает блок block в out (не меньше kBlockSize элементов); возвращает число значений.
+    // Блок с номером GetBlockCount() — неупакованный хвост
+    size_t DecodeBlock(size_t block, Type* out) const noexcept {
+        assert(block <= blocks_.GetSize());
+        if (block == blocks_.GetSize()) {
+            std::copy(tail_.begin(), tail_.end(), out);
+            return tail_.GetSize();
+        }
+        const BlockHeader& header = blocks_[block];
+        if (header.width == 0) {
+            std::fill_n(out, kBlockSize, header.base);
+            return kBlockSize;
+        }
+#if SIMPLE_VECTOR_X86_SIMD
+        if (SimdCompare::GetLevel() != SimdLevel::kScalar) {
+            DecodeBlockSse2(header, out);
+            return kBlockSize;
+        }
+#endif
+        DecodeBlockScalar(header, out);
+        return kBlockSize;
+    }
+
+    // Распаковывает все значения в SimpleVector
+    SimpleVector<Type> Decompress() const {
+        // Все элементы сразу перезаписываются блоками, поэтому заполнять их нулями не нужно
+        SimpleVector<Type> result;
+        result.Reserve(size_);
+        result.ResizeForOverwrite(size_);
+        for (size_t block = 0; block <= blocks_.GetSize(); ++block) {
+            DecodeBlock(block, result.begin() + block * kBlockSize);
+        }
+        return result;
+    }
+
+    void Clear() noexcept {
+        blocks_.Clear();
+        words_.Clear();
+        tail_.Clear();
+        size_ = 0;
+    }
+
+    void ShrinkToFit() {
+        blocks_.ShrinkToFit();
+        words_.ShrinkToFit();
+        tail_.ShrinkToFit();
+    }
+
+    ConstIterator begin() const {
+        return ConstIterator(this, 0);
+    }
+
+    ConstIterator end() const {
+        return ConstIterator(this, size_);
+    }
+
+    ConstIterator cbegin() const {
+        return begin();
+    }
+
+    ConstIterator cend() const {
+        return end();
+    }
+
+    // Итератор последовательного обхода: хранит распакованный текущий блок,
+    // поэтому разыменование возвращает значение, а не ссылку
+    class ConstIterator {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using iterator_concept = std::forward_iterator_tag;
+        using value_type = Type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Type*;
+        using reference = Type;
+
+        ConstIterator() = default;
+
+        Type operator*() const noexcept {
+            return buffer_[index_ % kBlockSize];
+        }
+
+        ConstIterator& operator++() {
+            ++index_;
+            if (index_ % kBlockSize == 0 && index_ < owner_->size_) {
+                owner_->DecodeBlock(index_ / kBlockSize, buffer_.data());
+            }
+            return *this;
+        }
+
+        ConstIterator operator++(int) {
+            ConstIterator copy = *this;
+            ++*this;
+            return copy;
+        }
+
+        size_t GetIndex() const noexcept {
+            return index_;
+        }
+
+        bool operator==(const ConstIterator& rhs) const noexcept {
+            return index_ == rhs.index_;
+        }
+
+    private:
+        friend class CompressedVector;
+
+        const CompressedVector* owner_ = nullptr;
+        size_t index_ = 0;
+        std::array<Type, kBlockSize> buffer_{};
+
+        ConstIterator(const CompressedVector* owner, size_t index)
+            : owner_(owner)
+            , index_(index) {
+            if (index_ < owner_->size_) {
+                owner_->DecodeBlock(index_ / kBlockSize, buffer_.data());
+            }
+        }
+    };
+
+private:
+    static constexpr size_t kBits = sizeof(Type) * 8;
+    // Число строк по kLanes значений в блоке; упакованный блок занимает width строк слов
+    static constexpr size_t kRows = kBlockSize / kLanes;
+
+    struct BlockHeader {
+        Type base = 0;
+        uint8_t width = 0;
+        bool zigzag = false;
+        // Индекс первого слова блока в words_; блок занимает width * kLanes слов
+        size_t offset = 0;
+    };
+
+    SimpleVector<BlockHeader> blocks_;
+    SimpleVector<Type> words_;
+    SimpleVector<Type> tail_;
+    size_t size_ = 0;
+
+    static Type Mask(size_t width) noexcept {
+        return width == kBits ? ~Type{0} : static_cast<Type>((Type{1} << width) - 1);
+    }
+
+    static Type ZigzagEncode(Type delta) noexcept {
+        using Signed = std::make_signed_t<Type>;
+        return static_cast<Type>(delta << 1) ^ static_cast<Type>(static_cast<Signed>(delta) >> (kBits - 1));
+    }
+
+    static Type ZigzagDecode(Type code) noexcept {
+        return (code >> 1) ^ static_cast<Type>(Type{0} - (code & 1));
+    }
+
+    // Упаковывает kBlockSize значений начиная с values
+    void EncodeBlock(const Type* values) {
+        BlockHeader header;
+        header.base = values[0];
+        header.offset = words_.GetSize();
+        std::array<Type, kBlockSize> deltas;
+        deltas[0] = 0;
+        bool sorted = true;
+        for (size_t i = 1; i < kBlockSize; ++i) {
+            deltas[i] = values[i] - values[i - 1];
+            sorted = sorted && values[i] >= values[i - 1];
+        }
+        header.zigzag = !sorted;
+        Type used = 0;
+        for (Type& delta : deltas) {
+            if (header.zigzag) {
+                delta = ZigzagEncode(delta);
+            }
+            used |= delta;
+        }
+        header.width = static_cast<uint8_t>(std::bit_width(used));
+        words_.Resize(header.offset + header.width * kLanes);
+        Type* words = words_.begin() + header.offset;
+        for (size_t i = 0; i < kBlockSize && header.width != 0; ++i) {
+            const size_t lane = i % kLanes;
+            const size_t bit = i / kLanes * header.width;
+            const size_t row = bit / kBits;
+            const size_t shift = bit % kBits;
+            words[row * kLanes + lane] |= static_cast<Type>(deltas[i] << shift);
+            if (shift + header.width > kBits) {
+                words[(row + 1) * kLanes + lane] |= static_cast<Type>(deltas[i] >> (kBits - shift));
+            }
+        }
+        blocks_.PushBack(header);
+    }
+
+    // Разность с номером index внутри блока
+    Type DecodeDelta(const BlockHeader& header, size_t index) const noexcept {
+        const Type* words = words_.begin() + header.offset;
+        const size_t lane = index % kLanes;
+        const size_t bit = index / kLanes * header.width;
+        const size_t row = bit / kBits;
+        const size_t shift = bit % kBits;
+        Type code = words[row * kLanes + lane] >> shift;
+        if (shift + header.width > kBits) {
+            code |= static_cast<Type>(words[(row + 1) * kLanes + lane] << (kBits - shift));
+        }
+        code &= Mask(header.width);
+        return header.zigzag ? ZigzagDecode(code) : code;
+    }
+
+    Type DecodeValue(const BlockHeader& header, size_t index) const noexcept {
+        Type value = header.base;
+        if (header.width != 0) {
+            for (size_t i = 1; i <= index; ++i) {
+                value += DecodeDelta(header, i);
+            }
+        }
+        return value;
+    }
+
+    void DecodeBlockScalar(const BlockHeader& header, Type* out) const noexcept {
+        Type value = header.base;
+        for (size_t i = 0; i < kBlockSize; ++i) {
+            value += DecodeDelta(header, i);
+            out[i] = value;
+        }
+    }
+
+#if SIMPLE_VECTOR_X86_SIMD
+    // Строка за шаг: сдвиг и маска выделяют kLanes разностей, префиксная сумма в регистре
+    // прибавляет их к последнему значению предыдущей строки. Разность первого значения блока равна нулю,
+    // поэтому первая строка отсчитывается от base
+    __attribute__((target("sse2")))
+    void DecodeBlockSse2(const BlockHeader& header, Type* out) const noexcept {
+        const Type* words = words_.begin() + header.offset;
+        const size_t width = header.width;
+        const __m128i mask = Broadcast(Mask(width));
+        const __m128i one = Broadcast(Type{1});
+        __m128i previous = Broadcast(header.base);
+        for (size_t row = 0; row < kRows; ++row) {
+            const size_t bit = row * width;
+            const size_t word_row = bit / kBits;
+            const size_t shift = bit % kBits;
+            __m128i code = ShiftRight(_mm_loadu_si128(reinterpret_cast<const __m128i*>(words + word_row * kLanes)), shift);
+            if (shift + width > kBits) {
+                code = _mm_or_si128(code,
+                    ShiftLeft(_mm_loadu_si128(reinterpret_cast<const __m128i*>(words + (word_row + 1) * kLanes)), kBits - shift));
+            }
+            code = _mm_and_si128(code, mask);
+            if (header.zigzag) {
+                code = _mm_xor_si128(ShiftRight(code, 1), Subtract(_mm_setzero_si128(), _mm_and_si128(code, one)));
+            }
+            // Префиксная сумма по дорожкам
+            if constexpr (kLanes == 4) {
+                code = _mm_add_epi32(code, _mm_slli_si128(code, 4));
+                code = _mm_add_epi32(code, _mm_slli_si128(code, 8));
+                code = _mm_add_epi32(code, previous);
+                previous = _mm_shuffle_epi32(code, _MM_SHUFFLE(3, 3, 3, 3));
+            }
+            else {
+                code = _mm_add_epi64(code, _mm_slli_si128(code, 8));
+                code = _mm_add_epi64(code, previous);
+                previous = _mm_unpackhi_epi64(code, code);
+            }
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + row * kLanes), code);
+        }
+    }
+
+    __attribute__((target("sse2")))
+    static __m128i Broadcast(Type value) noexcept {
+        if constexpr (kLanes == 4) {
+            return _mm_set1_epi32(static_cast<int>(value));
+        }
+        else {
+            return _mm_set1_epi64x(static_cast<long long>(value));
+        }
+    }
+
+    __attribute__((target("sse2")))
+    static __m128i ShiftRight(__m128i value, size_t shift) noexcept {
+        const __m128i count = _mm_cvtsi32_si128(static_cast<int>(shift));
+        return kLanes == 4 ? _mm_srl_epi32(value, count) : _mm_srl_epi64(value, count);
+    }
+
+    __attribute__((target("sse2")))
+    static __m128i ShiftLeft(__m128i value, size_t shift) noexcept {
+        const __m128i count = _mm_cvtsi32_si128(static_cast<int>(shift));
+        return kLanes == 4 ? _mm_sll_epi32(value, count) : _mm_sll_epi64(value, count);
+    }
+
+    __attribute__((target("sse2")))
+    static __m128i Subtract(__m128i lhs, __m128i rhs) noexcept {
+        return kLanes == 4 ? _mm_sub_epi32(lhs, rhs) : _mm_sub_epi64(lhs, rhs);
+    }
+#endif
+};
+
+template <typename Type>
+bool operator==(const CompressedVector<Type>& lhs, const CompressedVector<Type>& rhs) {
+    return lhs.GetSize() == rhs.GetSize() && std::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+template <typename Type>
+bool operator!=(const CompressedVector<Type>& lhs, const CompressedVector<Type>& rhs) {
+    return !(lhs == rhs);
+}
@@ -0,0 +1,234 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "allocator.h"
+#include "array_ptr.h"
+#include "simple_vector.h"
+
+// Вектор, в который несколько потоков одновременно добавляют элементы без блокировок.
+// Элементы хранятся в сегментах ArrayPtr, каждый следующий вдвое больше предыдущего,
+// поэтому при росте элементы не переносятся и ссылки на них остаются действительными.
+// Чтение элементов [0, GetSize()) безопасно одновременно с добавлением новых.
+// Остальные методы (Reserve, Drain, Clear, деструктор) не должны выполняться одновременно с другими операциями
+template <typename Type, typename Allocator = MallocAllocator<Type>>
+class ConcurrentVector {
+public:
+    static_assert(std::is_nothrow_move_constructible_v<Type>,
+        "a claimed slot must always be filled, so elements are moved into it without exceptions");
+
+    using AllocatorType = Allocator;
+
+    ConcurrentVector() = default;
+
+    explicit ConcurrentVector(const Allocator& alloc) noexcept
+        : alloc_(alloc) {
+    }
+
+    ConcurrentVector(const ConcurrentVector&) = delete;
+    ConcurrentVector& operator=(const ConcurrentVector&) = delete;
+
+    ~ConcurrentVector() {
+        Clear();
+    }
+
+    void PushBack(const Type& item) {
+        EmplaceBack(item);
+    }
+
+    void PushBack(Type&& item) {
+        EmplaceBack(std::move(item));
+    }
+
+    // Конструирует элемент и добавляет его в конец; безопасно вызывать из нескольких потоков.
+    // Возвращает ссылку на элемент, которая не меняется до Drain или разрушения вектора
+    template <typename... Args>
+    Type& EmplaceBack(Args&&... args) {
+        // Всё, что может выбросить исключение, выполняется до того, как место в векторе занято
+        Type item(std::forward<Args>(args)...);
+        size_t index = claimed_.load(std::memory_order_relaxed);
+        Segment* segment;
+        // Сегмент занятого индекса уже записан в segments_ этим или другим потоком (EnsureSegment).
+        // Захват индекса с release публикует его вместе с сегментом: читатель, увидевший claimed_
+        // с acquire (GetSize, Drain, Clear), видит и ненулевой указатель на сегмент
+        do {
+            segment = EnsureSegment(SegmentOf(index));
+        } while (!claimed_.compare_exchange_weak(index, index + 1, std::memory_order_release, std::memory_order_relaxed));
+
+        const size_t offset = index - SegmentStart(SegmentOf(index));
+        Type* slot = new (segment->items.Get() + offset) Type(std::move(item));
+        segment->ready[offset].store(true, std::memory_order_release);
+        return *slot;
+    }
+
+    // Число элементов, доступных для чтения: все элементы с меньшими индексами уже сконструированы.
+    // Элементы, которые ещё конструируются другими потоками, не учитываются
+    size_t GetSize() const noexcept {
+        size_t published = published_.load(std::memory_order_acquire);
+        const size_t claimed = claimed_.load(std::memory_order_acquire);
+        size_t prefix = published;
+        while (prefix < claimed && IsReady(prefix)) {
+            ++prefix;
+        }
+        // Продвигаем общий счётчик, чтобы следующим вызовам не проверять те же элементы
+        while (published < prefix && !published_.compare_exchange_weak(published, prefix, std::memory_order_acq_rel)) {
+        }
+        return prefix;
+    }
+
+    bool IsEmpty() const noexcept {
+        return GetSize() == 0;
+    }
+
+    // Доступ к элементу с индексом меньше GetSize()
+    Type& operator[](size_t index) noexcept {
+        return *Locate(index);
+    }
+
+    const Type& operator[](size_t index) const noexcept {
+        return *Locate(index);
+    }
+
+    // Выбрасывает исключение std::out_of_range, если index >= GetSize()
+    Type& At(size_t index) {
+        if (index >= GetSize()) {
+            throw std::out_of_range("out_of_range");
+        }
+        return *Locate(index);
+    }
+
+    const Type& At(size_t index) const {
+        if (index >= GetSize()) {
+            throw std::out_of_range("out_of_range");
+        }
+        return *Locate(index);
+    }
+
+    // Заранее выделяет сегменты под capacity элементов, чтобы добавление не обращалось к аллокатору
+    void Reserve(size_t capacity) {
+        for (size_t index = 0; index < capacity; index = SegmentStart(SegmentOf(index) + 1)) {
+            EnsureSegment(SegmentOf(index));
+        }
+    }
+
+    // Копирует опубликованные элементы в непрерывный SimpleVector
+    template <typename GrowthPolicy = DoublingGrowth>
+    SimpleVector<Type, Allocator, GrowthPolicy> Snapshot() const {
+        SimpleVector<Type, Allocator, GrowthPolicy> result(alloc_);
+        const size_t size = GetSize();
+        result.Reserve(size);
+        ForEachSegment(size, [&result](Type* first, Type* last) {
+            result.Append(first, last);
+        });
+        return result;
+    }
+
+    // Переносит все элементы в непрерывный SimpleVector и освобождает сегменты.
+    // Вызывается, когда добавление завершено
+    template <typename GrowthPolicy = DoublingGrowth>
+    SimpleVector<Type, Allocator, GrowthPolicy> Drain() {
+        SimpleVector<Type, Allocator, GrowthPolicy> result(alloc_);
+        const size_t size = claimed_.load(std::memory_order_acquire);
+        assert(size == GetSize());
+        // Блок выделяется один раз, и каждый сегмент переносится в него одним перемещением элементов
+        result.Reserve(size);
+        ForEachSegment(size, [&result](Type* first, Type* last) {
+            result.Append(std::make_move_iterator(first), std::make_move_iterator(last));
+        });
+        Clear();
+        return result;
+    }
+
+    // Разрушает элементы и освобождает сегменты
+    void Clear() noexcept {
+        ForEachSegment(claimed_.load(std::memory_order_acquire), [](Type* first, Type* last) {
+            std::destroy(first, last);
+        });
+        for (std::atomic<Segment*>& segment : segments_) {
+            delete segment.exchange(nullptr, std::memory_order_relaxed);
+        }
+        claimed_.store(0, std::memory_order_relaxed);
+        published_.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    // Размер первого сегмента; сегмент k вмещает kFirstSegmentSize << k элементов
+    static constexpr size_t kFirstSegmentSize = 32;
+    static constexpr size_t kMaxSegments = 64 - std::bit_width(kFirstSegmentSize) + 1;
+
+    struct Segment {
+        ArrayPtr<Type, Allocator> items;
+        // Флаги готовности элементов: элемент можно читать после записи true
+        ArrayPtr<std::atomic<bool>> ready;
+
+        Segment(size_t size, const Allocator& alloc)
+            : items(size, RawMemoryTag{}, alloc)
+            , ready(size) {
+        }
+    };
+
+    std::array<std::atomic<Segment*>, kMaxSegments> segments_{};
+    std::atomic<size_t> claimed_{0};
+    mutable std::atomic<size_t> published_{0};
+    [[no_unique_address]] Allocator alloc_;
+
+    static size_t SegmentOf(size_t index) noexcept {
+        return std::bit_width(index / kFirstSegmentSize + 1) - 1;
+    }
+
+    static size_t SegmentStart(size_t segment) noexcept {
+        return kFirstSegmentSize * ((size_t{1} << segment) - 1);
+    }
+
+    static size_t SegmentSize(size_t segment) noexcept {
+        return kFirstSegmentSize << segment;
+    }
+
+    // Возвращает сегмент, выделяя его, если его ещё нет.
+    // Если сегмент одновременно выделили несколько потоков, остаётся первый, остальные освобождаются
+    Segment* EnsureSegment(size_t segment) {
+        if (segment >= kMaxSegments) {
+            throw std::length_error("ConcurrentVector is too large");
+        }
+        Segment* current = segments_[segment].load(std::memory_order_acquire);
+        if (current != nullptr) {
+            return current;
+        }
+        auto fresh = std::make_unique<Segment>(SegmentSize(segment), alloc_);
+        if (segments_[segment].compare_exchange_strong(current, fresh.get(), std::memory_order_acq_rel)) {
+            return fresh.release();
+        }
+        return current;
+    }
+
+    // Сегмент, которого ещё нет, не содержит готовых элементов
+    bool IsReady(size_t index) const noexcept {
+        const size_t segment = SegmentOf(index);
+        const Segment* current = segments_[segment].load(std::memory_order_acquire);
+        return current != nullptr && current->ready[index - SegmentStart(segment)].load(std::memory_order_acquire);
+    }
+
+    Type* Locate(size_t index) const noexcept {
+        assert(index < GetSize());
+        const size_t segment = SegmentOf(index);
+        return segments_[segment].load(std::memory_order_acquire)->items.Get() + (index - SegmentStart(segment));
+    }
+
+    // Вызывает body(first, last) для непрерывных частей элементов [0, size) по сегментам
+    template <typename Body>
+    void ForEachSegment(size_t size, const Body& body) const {
+        for (size_t segment = 0; SegmentStart(segment) < size; ++segment) {
+            Type* first = segments_[segment].load(std::memory_order_acquire)->items.Get();
+            body(first, first + std::min(SegmentSize(segment), size - SegmentStart(segment)));
+        }
+    }
+};
@@ -0,0 +1,377 @@
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+#include "allocator.h"
+#include "growth_policy.h"
+#include "simple_vector.h"
+
+// Вектор с копированием при записи. Копии разделяют один буфер со счётчиком ссылок,
+// поэтому копирование занимает O(1); буфер клонируется при первом изменяющем вызове
+// в копии, которая разделяет его с другими. Счётчик атомарный: копии можно передавать
+// в другие потоки, но один объект CowSimpleVector, как и SimpleVector, нельзя изменять одновременно из нескольких.
+// Неконстантные operator[], At, begin и end тоже считаются изменяющими: для чтения без клонирования
+// используйте константный доступ или GetVector(). Изменяемые ссылки и итераторы, которые выдают эти методы
+// (и EmplaceBack, Insert, Erase), остаются действительными, поэтому такой буфер не разделяется:
+// копии объекта, выдавшего их, сразу получают собственный буфер, и запись через ссылку не видна в копиях.
+// Когда элементы переезжают в новый блок (рост, ShrinkToFit) или удаляются Clear, буфер снова разделяется
+template <typename Type, typename Allocator = MallocAllocator<Type>, typename GrowthPolicy = DoublingGrowth>
+class CowSimpleVector {
+public:
+    using Vector = SimpleVector<Type, Allocator, GrowthPolicy>;
+    using Iterator = typename Vector::Iterator;
+    using ConstIterator = typename Vector::ConstIterator;
+    using AllocatorType = Allocator;
+
+    CowSimpleVector() noexcept = default;
+
+    explicit CowSimpleVector(const Allocator& alloc)
+        : alloc_(alloc)
+        , shared_(Create(alloc_, Vector(alloc_))) {
+    }
+
+    explicit CowSimpleVector(size_t size, const Allocator& alloc = Allocator())
+        : alloc_(alloc)
+        , shared_(Create(alloc_, Vector(size, alloc_))) {
+    }
+
+    CowSimpleVector(size_t size, const Type& value, const Allocator& alloc = Allocator())
+        : alloc_(alloc)
+        , shared_(Create(alloc_, Vector(size, value, alloc_))) {
+    }
+
+    CowSimpleVector(std::initializer_list<Type> init, const Allocator& alloc = Allocator())
+        : alloc_(alloc)
+        , shared_(Create(alloc_, Vector(init, alloc_))) {
+    }
+
+    // Забирает элементы обычного вектора без копирования
+    explicit CowSimpleVector(Vector&& items)
+        : alloc_(items.GetAllocator())
+        , shared_(Create(alloc_, std::move(items))) {
+    }
+
+    CowSimpleVector(const CowSimpleVector& other)
+        : alloc_(AllocTraits::select_on_container_copy_construction(other.alloc_))
+        , shared_(Share(other.shared_, alloc_)) {
+    }
+
+    CowSimpleVector(CowSimpleVector&& other) noexcept
+        : alloc_(other.alloc_)
+        , shared_(std::exchange(other.shared_, nullptr)) {
+    }
+
+    // Аллокатор копии заменяется, только если это разрешают propagate_on_container_*_assignment,
+    // как в SimpleVector; разделяемый буфер при этом остаётся со своим аллокатором
+    CowSimpleVector& operator=(const CowSimpleVector& rhs) {
+        if (this != &rhs) {
+            constexpr bool kPropagate = AllocTraits::propagate_on_container_copy_assignment::value;
+            Release(std::exchange(shared_, Share(rhs.shared_, kPropagate ? rhs.alloc_ : alloc_)));
+            if constexpr (kPropagate) {
+                alloc_ = rhs.alloc_;
+            }
+        }
+        return *this;
+    }
+
+    CowSimpleVector& operator=(CowSimpleVector&& rhs) noexcept {
+        if (this != &rhs) {
+            Release(std::exchange(shared_, std::exchange(rhs.shared_, nullptr)));
+            if constexpr (AllocTraits::propagate_on_container_move_assignment::value) {
+                alloc_ = rhs.alloc_;
+            }
+        }
+        return *this;
+    }
+
+    ~CowSimpleVector() {
+        Release(shared_);
+    }
+
+    // Обычный вектор с элементами, для передачи в код, который принимает SimpleVector
+    const Vector& GetVector() const noexcept {
+        return shared_ != nullptr ? shared_->items : EmptyVector();
+    }
+
+    // Разделяет ли вектор буфер с другими копиями
+    bool IsShared() const noexcept {
+        return shared_ != nullptr && shared_->refs.load(std::memory_order_acquire) != 1;
+    }
+
+    size_t GetSize() const noexcept {
+        return GetVector().GetSize();
+    }
+
+    size_t GetCapacity() const noexcept {
+        return GetVector().GetCapacity();
+    }
+
+    bool IsEmpty() const noexcept {
+        return GetVector().IsEmpty();
+    }
+
+    const Type& operator[](size_t index) const noexcept {
+        return GetVector()[index];
+    }
+
+    Type& operator[](size_t index) {
+        return Exposed()[index];
+    }
+
+    const Type& At(size_t index) const {
+        return GetVector().At(index);
+    }
+
+    Type& At(size_t index) {
+        if (index >= GetSize()) {
+            throw std::out_of_range("out_of_range");
+        }
+        return Exposed()[index];
+    }
+
+    void Reserve(size_t new_capacity) {
+        if (new_capacity > GetCapacity()) {
+            Modify([new_capacity](Vector& items) {
+                items.Reserve(new_capacity);
+            });
+        }
+    }
+
+    void ShrinkToFit() {
+        if (GetCapacity() > GetSize()) {
+            Modify([](Vector& items) {
+                items.ShrinkToFit();
+            });
+        }
+    }
+
+    // Очищает вектор; разделяемый буфер не клонируется, а просто отпускается
+    void Clear() noexcept {
+        if (IsShared()) {
+            Release(std::exchange(shared_, nullptr));
+        }
+        else if (shared_ != nullptr) {
+            // Ссылки на разрушенные элементы больше нельзя использовать, поэтому буфер снова можно разделять
+            shared_->items.Clear();
+            shared_->unshareable = false;
+        }
+    }
+
+    void Resize(size_t new_size) {
+        Modify([new_size](Vector& items) {
+            items.Resize(new_size);
+        });
+    }
+
+    void PushBack(const Type& item) {
+        Modify([&item](Vector& items) {
+            items.PushBack(item);
+        });
+    }
+
+    void PushBack(Type&& item) {
+        Modify([&item](Vector& items) {
+            items.PushBack(std::move(item));
+        });
+    }
+
+    template <typename... Args>
+    Type& EmplaceBack(Args&&... args) {
+        return Exposed().EmplaceBack(std::forward<Args>(args)...);
+    }
+
+    // Позиции pos относятся к буферу до клонирования, поэтому сначала переводятся в индексы
+    Iterator Insert(ConstIterator pos, const Type& value) {
+        const size_t index = pos - cbegin();
+        Vector& items = Exposed();
+        return items.Insert(items.cbegin() + index, value);
+    }
+
+    Iterator Insert(ConstIterator pos, Type&& value) {
+        const size_t index = pos - cbegin();
+        Vector& items = Exposed();
+        return items.Insert(items.cbegin() + index, std::move(value));
+    }
+
+    template <std::input_iterator InputIt>
+    Iterator Insert(ConstIterator pos, InputIt first, InputIt last) {
+        const size_t index = pos - cbegin();
+        Vector& items = Exposed();
+        return items.Insert(items.cbegin() + index, first, last);
+    }
+
+    void PopBack() {
+        Mutable().PopBack();
+    }
+
+    Iterator Erase(ConstIterator pos) {
+        const size_t index = pos - cbegin();
+        Vector& items = Exposed();
+        return items.Erase(items.cbegin() + index);
+    }
+
+    Iterator Erase(ConstIterator first, ConstIterator last) {
+        const size_t from = first - cbegin();
+        const size_t to = last - cbegin();
+        Vector& items = Exposed();
+        return items.Erase(items.cbegin() + from, items.cbegin() + to);
+    }
+
+    void swap(CowSimpleVector& other) noexcept {
+        if constexpr (AllocTraits::propagate_on_container_swap::value) {
+            std::swap(alloc_, other.alloc_);
+        }
+        std::swap(shared_, other.shared_);
+    }
+
+    Iterator begin() {
+        return Exposed().begin();
+    }
+
+    Iterator end() {
+        return Exposed().end();
+    }
+
+    ConstIterator begin() const noexcept {
+        return GetVector().begin();
+    }
+
+    ConstIterator end() const noexcept {
+        return GetVector().end();
+    }
+
+    ConstIterator cbegin() const noexcept {
+        return begin();
+    }
+
+    ConstIterator cend() const noexcept {
+        return end();
+    }
+
+private:
+    // Разделяемый буфер: вектор и число ссылающихся на него копий.
+    // unshareable меняет только единственный владелец буфера
+    struct Shared {
+        std::atomic<size_t> refs{1};
+        bool unshareable = false;
+        Vector items;
+
+        explicit Shared(Vector&& vector) noexcept
+            : items(std::move(vector)) {
+        }
+    };
+
+    using AllocTraits = std::allocator_traits<Allocator>;
+    using SharedAllocator = typename AllocTraits::template rebind_alloc<Shared>;
+    using SharedTraits = std::allocator_traits<SharedAllocator>;
+
+    // Аллокатор, которым создаются буферы этой копии, в том числе после Clear и перемещения
+    [[no_unique_address]] Allocator alloc_;
+    Shared* shared_ = nullptr;
+
+    static const Vector& EmptyVector() noexcept {
+        static const Vector empty;
+        return empty;
+    }
+
+    static Shared* Create(const Allocator& alloc, Vector&& items) {
+        SharedAllocator shared_alloc(alloc);
+        Shared* shared = SharedTraits::allocate(shared_alloc, 1);
+        SharedTraits::construct(shared_alloc, shared, std::move(items));
+        return shared;
+    }
+
+    static void Retain(Shared* shared) noexcept {
+        if (shared != nullptr) {
+            shared->refs.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    // Буфер для новой копии: тот же, если на его элементы не выданы изменяемые ссылки, иначе клон в alloc
+    static Shared* Share(Shared* shared, const Allocator& alloc) {
+        if (shared != nullptr && shared->unshareable) {
+            return Create(alloc, Vector(shared->items, alloc));
+        }
+        Retain(shared);
+        return shared;
+    }
+
+    // Последняя копия разрушает буфер; acq_rel гарантирует, что чтения других копий завершились раньше
+    static void Release(Shared* shared) noexcept {
+        if (shared != nullptr && shared->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            SharedAllocator shared_alloc(shared->items.GetAllocator());
+            SharedTraits::destroy(shared_alloc, shared);
+            SharedTraits::deallocate(shared_alloc, shared, 1);
+        }
+    }
+
+    // Возвращает вектор, которым владеет только эта копия, клонируя разделяемый буфер
+    Vector& Mutable() {
+        if (shared_ == nullptr) {
+            shared_ = Create(alloc_, Vector(alloc_));
+        }
+        else if (shared_->refs.load(std::memory_order_acquire) != 1) {
+            Shared* unique = Create(alloc_, Vector(shared_->items, alloc_));
+            Release(std::exchange(shared_, unique));
+        }
+        return shared_->items;
+    }
+
+    // Изменяет вектор методом, который не выдаёт ссылок. Если элементы при этом переехали в другой блок,
+    // прежние ссылки и итераторы недействительны, и буфер снова можно разделять
+    template <typename Change>
+    void Modify(const Change& change) {
+        Vector& items = Mutable();
+        const Type* data = items.begin();
+        change(items);
+        if (items.begin() != data) {
+            shared_->unshareable = false;
+        }
+    }
+
+    // Как Mutable, но для методов, выдающих изменяемые ссылки и итераторы: буфер не разделяется,
+    // пока элементы не переедут в другой блок или не будут удалены Clear
+    Vector& Exposed() {
+        Vector& items = Mutable();
+        shared_->unshareable = true;
+        return items;
+    }
+};
+
+template <typename Type, typename Allocator, typename GrowthPolicy>
+bool operator==(const CowSimpleVector<Type, Allocator, GrowthPolicy>& lhs, const CowSimpleVector<Type, Allocator, GrowthPolicy>& rhs) {
+    // Копии одного буфера равны без сравнения элементов
+    return &lhs.GetVector() == &rhs.GetVector() || lhs.GetVector() == rhs.GetVector();
+}
+
+template <typename Type, typename Allocator, typename GrowthPolicy>
+bool operator!=(const CowSimpleVector<Type, Allocator, GrowthPolicy>& lhs, const CowSimpleVector<Type, Allocator, GrowthPolicy>& rhs) {
+    return !(lhs == rhs);
+}
+
+template <typename Type, typename Allocator, typename GrowthPolicy>
+bool operator<(const CowSimpleVector<Type, Allocator, GrowthPolicy>& lhs, const CowSimpleVector<Type, Allocator, GrowthPolicy>& rhs) {
+    return lhs.GetVector() < rhs.GetVector();
+}
+
+template <typename Type, typename Allocator, typename GrowthPolicy>
+bool operator<=(const CowSimpleVector<Type, Allocator, GrowthPolicy>& lhs, const CowSimpleVector<Type, Allocator, GrowthPolicy>& rhs) {
+    return !(rhs < lhs);
+}
+
+template <typename Type, typename Allocator, typename GrowthPolicy>
+bool operator>(const CowSimpleVector<Type, Allocator, GrowthPolicy>& lhs, const CowSimpleVector<Type, Allocator, GrowthPolicy>& rhs) {
+    return rhs < lhs;
+}
+
+template <typename Type, typename Allocator, typename GrowthPolicy>
+bool operator>=(const CowSimpleVector<Type, Allocator, GrowthPolicy>& lhs, const CowSimpleVector<Type, Allocator, GrowthPolicy>& rhs) {
+    return !(lhs < rhs);
+}
@@ -0,0 +1,460 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "allocator.h"
+#include "flat_search.h"
+#include "simple_vector.h"
+
+// Упорядоченный словарь на двух SimpleVector: отсортированные ключи и значения с теми же индексами.
+// Поиск просматривает только плотный массив ключей, поэтому в кэш не попадают значения.
+// Поиск — двоичный без ветвлений или по копии ключей в порядке Эйтцингера (SearchLayout).
+// Одиночная вставка и удаление стоят O(n); для обновлений пачкой есть InsertBatch
+template <typename Key, typename Value, typename Compare = std::less<Key>,
+    typename KeyAllocator = MallocAllocator<Key>, typename ValueAllocator = MallocAllocator<Value>>
+class FlatMap {
+public:
+    using KeyVector = SimpleVector<Key, KeyAllocator>;
+    using ValueVector = SimpleVector<Value, ValueAllocator>;
+
+    // Итератор по парам ключ–значение; разыменование возвращает пару ссылок на элементы двух векторов.
+    // Ключ доступен только для чтения, чтобы не нарушить порядок
+    template <bool Const>
+    class EntryIterator {
+    public:
+        using MappedPointer = std::conditional_t<Const, const Value*, Value*>;
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = std::pair<Key, Value>;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::pair<const Key&, std::conditional_t<Const, const Value&, Value&>>;
+        using pointer = void;
+
+        EntryIterator() noexcept = default;
+
+        EntryIterator(const Key* keys, MappedPointer values, size_t index) noexcept
+            : keys_(keys)
+            , values_(values)
+            , index_(index) {
+        }
+
+        // Неконстантный итератор неявно приводится к константному
+        operator EntryIterator<true>() const noexcept {
+            return EntryIterator<true>(keys_, values_, index_);
+        }
+
+        size_t GetIndex() const noexcept {
+            return index_;
+        }
+
+        const Key& GetKey() const noexcept {
+            return keys_[index_];
+        }
+
+        auto& GetValue() const noexcept {
+            return values_[index_];
+        }
+
+        reference operator*() const noexcept {
+            return reference(keys_[index_], values_[index_]);
+        }
+
+        reference operator[](difference_type offset) const noexcept {
+            return reference(keys_[index_ + offset], values_[index_ + offset]);
+        }
+
+        EntryIterator& operator++() noexcept {
+            ++index_;
+            return *this;
+        }
+
+        EntryIterator operator++(int) noexcept {
+            EntryIterator copy = *this;
+            ++index_;
+            return copy;
+        }
+
+        EntryIterator& operator--() noexcept {
+            --index_;
+            return *this;
+        }
+
+        EntryIterator operator--(int) noexcept {
+            EntryIterator copy = *this;
+            --index_;
+            return copy;
+        }
+
+        EntryIterator& operator+=(difference_type offset) noexcept {
+            index_ += offset;
+            return *this;
+        }
+
+        EntryIterator& operator-=(difference_type offset) noexcept {
+            index_ -= offset;
+            return *this;
+        }
+
+        friend EntryIterator operator+(EntryIterator it, difference_type offset) noexcept {
+            return it += offset;
+        }
+
+        friend EntryIterator operator+(difference_type offset, EntryIterator it) noexcept {
+            return it += offset;
+        }
+
+        friend EntryIterator operator-(EntryIterator it, difference_type offset) noexcept {
+            return it -= offset;
+        }
+
+        friend difference_type operator-(const EntryIterator& lhs, const EntryIterator& rhs) noexcept {
+            return static_cast<difference_type>(lhs.index_) - static_cast<difference_type>(rhs.index_);
+        }
+
+        friend bool operator==(const EntryIterator& lhs, const EntryIterator& rhs) noexcept {
+            return lhs.index_ == rhs.index_;
+        }
+
+        friend auto operator<=>(const EntryIterator& lhs, const EntryIterator& rhs) noexcept {
+            return lhs.index_ <=> rhs.index_;
+        }
+
+    private:
+        const Key* keys_ = nullptr;
+        MappedPointer values_ = nullptr;
+        size_t index_ = 0;
+    };
+
+    using Iterator = EntryIterator<false>;
+    using ConstIterator = EntryIterator<true>;
+
+    FlatMap() = default;
+
+    explicit FlatMap(const Compare& comp)
+        : index_(comp) {
+    }
+
+    // Строит словарь из пар: сортирует их по ключу и оставляет первую пару с каждым ключом
+    template <std::input_iterator InputIt>
+    FlatMap(InputIt first, InputIt last, const Compare& comp = Compare())
+        : index_(comp) {
+        SimpleVector<std::pair<Key, Value>> entries;
+        entries.Append(first, last);
+        SortAndDeduplicate(entries);
+        keys_.Reserve(entries.GetSize());
+        values_.Reserve(entries.GetSize());
+        for (auto& [key, value] : entries) {
+            keys_.PushBack(std::move(key));
+            values_.PushBack(std::move(value));
+        }
+        Rebuild();
+    }
+
+    FlatMap(std::initializer_list<std::pair<Key, Value>> init, const Compare& comp = Compare())
+        : FlatMap(init.begin(), init.end(), comp) {
+    }
+
+    // Забирает уже отсортированные ключи без повторов и соответствующие им значения
+    FlatMap(SortedUniqueTag, KeyVector keys, ValueVector values, const Compare& comp = Compare())
+        : keys_(std::move(keys))
+        , values_(std::move(values))
+        , index_(comp) {
+        if (keys_.GetSize() != values_.GetSize()) {
+            throw std::invalid_argument("keys and values differ in size");
+        }
+        Rebuild();
+    }
+
+    size_t GetSize() const noexcept {
+        return keys_.GetSize();
+    }
+
+    bool IsEmpty() const noexcept {
+        return keys_.IsEmpty();
+    }
+
+    // Отсортированные ключи
+    const KeyVector& GetKeys() const noexcept {
+        return keys_;
+    }
+
+    // Значения в порядке ключей
+    const ValueVector& GetValues() const noexcept {
+        return values_;
+    }
+
+    SearchLayout GetLayout() const noexcept {
+        return index_.GetLayout();
+    }
+
+    void SetLayout(SearchLayout layout) {
+        index_.SetLayout(layout, keys_.begin(), keys_.GetSize());
+    }
+
+    void Reserve(size_t capacity) {
+        keys_.Reserve(capacity);
+        values_.Reserve(capacity);
+    }
+
+    void Clear() {
+        keys_.Clear();
+        values_.Clear();
+        Rebuild();
+    }
+
+    template <typename Other>
+    Iterator Find(const Other& key) {
+        const size_t index = FindIndex(key);
+        return MakeIterator(index);
+    }
+
+    template <typename Other>
+    ConstIterator Find(const Other& key) const {
+        const size_t index = FindIndex(key);
+        return MakeIterator(index);
+    }
+
+    template <typename Other>
+    bool Contains(const Other& key) const {
+        return FindIndex(key) != GetSize();
+    }
+
+    template <typename Other>
+    size_t Count(const Other& key) const {
+        return Contains(key) ? 1 : 0;
+    }
+
+    // Первая пара с ключом, не меньшим key
+    template <typename Other>
+    ConstIterator LowerBound(const Other& key) const {
+        return MakeIterator(LowerBoundIndex(key));
+    }
+
+    // Первая пара с ключом, большим key
+    template <typename Other>
+    ConstIterator UpperBound(const Other& key) const {
+        const size_t index = LowerBoundIndex(key);
+        return MakeIterator(index + (index_.IsMatch(keys_.begin(), keys_.GetSize(), index, key) ? 1 : 0));
+    }
+
+    // Выбрасывает исключение std::out_of_range, если ключа нет
+    template <typename Other>
+    Value& At(const Other& key) {
+        return values_[CheckedIndex(key)];
+    }
+
+    template <typename Other>
+    const Value& At(const Other& key) const {
+        return values_[CheckedIndex(key)];
+    }
+
+    // Возвращает значение по ключу, вставляя значение по умолчанию, если ключа нет
+    Value& operator[](const Key& key) {
+        return TryEmplace(key).first.GetValue();
+    }
+
+    Value& operator[](Key&& key) {
+        return TryEmplace(std::move(key)).first.GetValue();
+    }
+
+    // Вставляет пару, если ключа ещё нет; существующее значение не заменяется
+    std::pair<Iterator, bool> Insert(const Key& key, const Value& value) {
+        return TryEmplace(key, value);
+    }
+
+    std::pair<Iterator, bool> Insert(Key&& key, Value&& value) {
+        return TryEmplace(std::move(key), std::move(value));
+    }
+
+    // Вставляет значение, сконструированное из args, если ключа ещё нет
+    template <typename KeyArg, typename... Args>
+    std::pair<Iterator, bool> TryEmplace(KeyArg&& key, Args&&... args) {
+        const size_t index = LowerBoundIndex(key);
+        if (index_.IsMatch(keys_.begin(), keys_.GetSize(), index, key)) {
+            return {MakeIterator(index), false};
+        }
+        values_.Insert(values_.cbegin() + index, Value(std::forward<Args>(args)...));
+        try {
+            keys_.Insert(keys_.cbegin() + index, Key(std::forward<KeyArg>(key)));
+        }
+        catch (...) {
+            values_.Erase(values_.cbegin() + index);
+            throw;
+        }
+        Rebuild();
+        return {MakeIterator(index), true};
+    }
+
+    // Добавляет пары диапазона: пачка сортируется отдельно и сливается со словарём за один проход.
+    // Из пар с одинаковым ключом остаётся та, что уже была в словаре, иначе первая в пачке
+    template <std::input_iterator InputIt>
+    void InsertBatch(InputIt first, InputIt last) {
+        SimpleVector<std::pair<Key, Value>> batch;
+        batch.Append(first, last);
+        MergeBatch(batch);
+    }
+
+    template <std::ranges::input_range Range>
+        requires std::ranges::common_range<Range>
+    void InsertBatch(Range&& range) {
+        SimpleVector<std::pair<Key, Value>> batch;
+        batch.Append(std::forward<Range>(range));
+        MergeBatch(batch);
+    }
+
+    void InsertBatch(std::initializer_list<std::pair<Key, Value>> init) {
+        InsertBatch(init.begin(), init.end());
+    }
+
+    // Удаляет пару с ключом key; возвращает число удалённых пар
+    size_t Erase(const Key& key) {
+        const size_t index = FindIndex(key);
+        if (index == GetSize()) {
+            return 0;
+        }
+        EraseAt(index);
+        return 1;
+    }
+
+    Iterator Erase(ConstIterator pos) {
+        const size_t index = pos.GetIndex();
+        EraseAt(index);
+        return MakeIterator(index);
+    }
+
+    Iterator begin() noexcept {
+        return MakeIterator(0);
+    }
+
+    Iterator end() noexcept {
+        return MakeIterator(GetSize());
+    }
+
+    ConstIterator begin() const noexcept {
+        return MakeIterator(0);
+    }
+
+    ConstIterator end() const noexcept {
+        return MakeIterator(GetSize());
+    }
+
+    ConstIterator cbegin() const noexcept {
+        return begin();
+    }
+
+    ConstIterator cend() const noexcept {
+        return end();
+    }
+
+private:
+    KeyVector keys_;
+    ValueVector values_;
+    FlatSearchIndex<Key, Compare> index_;
+
+    Iterator MakeIterator(size_t index) noexcept {
+        return Iterator(keys_.begin(), values_.begin(), index);
+    }
+
+    ConstIterator MakeIterator(size_t index) const noexcept {
+        return ConstIterator(keys_.begin(), values_.begin(), index);
+    }
+
+    template <typename Other>
+    size_t LowerBoundIndex(const Other& key) const {
+        return index_.LowerBound(keys_.begin(), keys_.GetSize(), key);
+    }
+
+    // Индекс пары с ключом key или GetSize(), если ключа нет
+    template <typename Other>
+    size_t FindIndex(const Other& key) const {
+        const size_t index = LowerBoundIndex(key);
+        return index_.IsMatch(keys_.begin(), keys_.GetSize(), index, key) ? index : GetSize();
+    }
+
+    template <typename Other>
+    size_t CheckedIndex(const Other& key) const {
+        const size_t index = FindIndex(key);
+        if (index == GetSize()) {
+            throw std::out_of_range("key not found");
+        }
+        return index;
+    }
+
+    void EraseAt(size_t index) {
+        keys_.Erase(keys_.cbegin() + index);
+        values_.Erase(values_.cbegin() + index);
+        Rebuild();
+    }
+
+    void Rebuild() {
+        index_.Rebuild(keys_.begin(), keys_.GetSize());
+    }
+
+    // Устойчиво сортирует пары по ключу и оставляет первую пару из каждой группы с эквивалентными ключами
+    void SortAndDeduplicate(SimpleVector<std::pair<Key, Value>>& entries) const {
+        const Compare& comp = index_.GetCompare();
+        std::stable_sort(entries.begin(), entries.end(), [&comp](const auto& lhs, const auto& rhs) {
+            return comp(lhs.first, rhs.first);
+        });
+        const auto last = std::unique(entries.begin(), entries.end(), [&comp](const auto& lhs, const auto& rhs) {
+            return !comp(lhs.first, rhs.first);
+        });
+        entries.Erase(last, entries.end());
+    }
+
+    // Сливает отсортированную пачку с парами словаря в новые векторы за один проход
+    // и обменивает их с текущими; при равных ключах побеждает пара словаря
+    void MergeBatch(SimpleVector<std::pair<Key, Value>>& batch) {
+        SortAndDeduplicate(batch);
+        if (batch.IsEmpty()) {
+            return;
+        }
+        const Compare& comp = index_.GetCompare();
+        const size_t capacity = keys_.GetSize() + batch.GetSize();
+        KeyVector keys(keys_.GetAllocator());
+        ValueVector values(values_.GetAllocator());
+        keys.Reserve(capacity);
+        values.Reserve(capacity);
+
+        size_t old_index = 0;
+        auto entry = batch.begin();
+        while (old_index < keys_.GetSize() || entry != batch.end()) {
+            const bool take_old = entry == batch.end()
+                || (old_index < keys_.GetSize() && !comp(entry->first, keys_[old_index]));
+            if (take_old) {
+                if (entry != batch.end() && !comp(keys_[old_index], entry->first)) {
+                    ++entry;
+                }
+                keys.PushBack(std::move(keys_[old_index]));
+                values.PushBack(std::move(values_[old_index]));
+                ++old_index;
+            }
+            else {
+                keys.PushBack(std::move(entry->first));
+                values.PushBack(std::move(entry->second));
+                ++entry;
+            }
+        }
+        keys_.swap(keys);
+        values_.swap(values);
+        Rebuild();
+    }
+};
+
+template <typename Key, typename Value, typename Compare, typename KeyAllocator, typename ValueAllocator>
+bool operator==(const FlatMap<Key, Value, Compare, KeyAllocator, ValueAllocator>& lhs,
+    const FlatMap<Key, Value, Compare, KeyAllocator, ValueAllocator>& rhs) {
+    return lhs.GetKeys() == rhs.GetKeys() && lhs.GetValues() == rhs.GetValues();
+}
+
+template <typename Key, typename Value, typename Compare, typename KeyAllocator, typename ValueAllocator>
+bool operator!=(const FlatMap<Key, Value, Compare, KeyAllocator, ValueAllocator>& lhs,
+    const FlatMap<Key, Value, Compare, KeyAllocator, ValueAllocator>& rhs) {
+    return !(lhs == rhs);
+}
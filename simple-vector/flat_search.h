@@ -0,0 +1,122 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <functional>
+#include <utility>
+
+#include "simple_vector.h"
+
+// Поиск в отсортированных массивах для FlatSet и FlatMap
+
+// Тег для конструкторов, которые принимают уже отсортированные ключи без повторов
+struct SortedUniqueTag {
+};
+
+// Двоичный поиск без ветвлений: на каждом шаге выбор половины сводится к условной пересылке,
+// и процессор не теряет такты на неверно предсказанных переходах.
+// Возвращает индекс первого элемента, не меньшего key, или size
+template <typename Key, typename Other, typename Compare>
+size_t BranchlessLowerBound(const Key* keys, size_t size, const Other& key, const Compare& comp) {
+    if (size == 0) {
+        return 0;
+    }
+    const Key* base = keys;
+    size_t length = size;
+    while (length > 1) {
+        const size_t half = length / 2;
+        base = comp(base[half], key) ? base + half : base;
+        length -= half;
+    }
+    return static_cast<size_t>(base - keys) + (comp(*base, key) ? 1 : 0);
+}
+
+// Расположение ключей для поиска
+enum class SearchLayout {
+    // Поиск по отсортированному массиву
+    kSorted,
+    // Дополнительная копия ключей в порядке Эйтцингера (обход дерева поиска в ширину).
+    // Первые уровни дерева лежат рядом и остаются в кэше, поэтому поиск быстрее на больших наборах,
+    // но копию приходится перестраивать при каждом изменении
+    kEytzinger,
+};
+
+// Индекс для поиска по отсортированным ключам с выбранным расположением
+template <typename Key, typename Compare = std::less<Key>>
+class FlatSearchIndex {
+public:
+    explicit FlatSearchIndex(const Compare& comp = Compare())
+        : comp_(comp) {
+    }
+
+    const Compare& GetCompare() const noexcept {
+        return comp_;
+    }
+
+    SearchLayout GetLayout() const noexcept {
+        return layout_;
+    }
+
+    // Переключает расположение и перестраивает индекс по ключам keys
+    void SetLayout(SearchLayout layout, const Key* keys, size_t size) {
+        layout_ = layout;
+        Rebuild(keys, size);
+    }
+
+    // Перестраивает копию ключей после изменения отсортированного массива
+    void Rebuild(const Key* keys, size_t size) {
+        eytzinger_.Clear();
+        ranks_.Clear();
+        if (layout_ != SearchLayout::kEytzinger) {
+            eytzinger_.ShrinkToFit();
+            ranks_.ShrinkToFit();
+            return;
+        }
+        ranks_.Resize(size);
+        size_t next = 0;
+        FillRanks(1, size, next);
+        eytzinger_.Reserve(size);
+        for (size_t rank : ranks_) {
+            eytzinger_.PushBack(keys[rank]);
+        }
+    }
+
+    // Возвращает индекс в отсортированном массиве keys первого ключа, не меньшего key, или size
+    template <typename Other>
+    size_t LowerBound(const Key* keys, size_t size, const Other& key) const {
+        if (layout_ == SearchLayout::kSorted) {
+            return BranchlessLowerBound(keys, size, key, comp_);
+        }
+        // Узел k хранится в eytzinger_[k - 1], его потомки — узлы 2k и 2k + 1
+        size_t node = 1;
+        while (node <= size) {
+            node = 2 * node + (comp_(eytzinger_[node - 1], key) ? 1 : 0);
+        }
+        // Спуск закончился правыми шагами от искомого узла, их и отбрасываем
+        node >>= std::countr_one(node) + 1;
+        return node == 0 ? size : ranks_[node - 1];
+    }
+
+    // Сообщает, эквивалентен ли ключ keys[index] ключу key
+    template <typename Other>
+    bool IsMatch(const Key* keys, size_t size, size_t index, const Other& key) const {
+        return index < size && !comp_(key, keys[index]);
+    }
+
+private:
+    [[no_unique_address]] Compare comp_;
+    SearchLayout layout_ = SearchLayout::kSorted;
+    SimpleVector<Key> eytzinger_;
+    // ranks_[k - 1] — индекс узла k в отсортированном массиве
+    SimpleVector<size_t> ranks_;
+
+    // Симметричный обход дерева узлов [1, size] нумерует узлы в порядке возрастания ключей
+    void FillRanks(size_t node, size_t size, size_t& next) {
+        if (node > size) {
+            return;
+        }
+        FillRanks(2 * node, size, next);
+        ranks_[node - 1] = next++;
+        FillRanks(2 * node + 1, size, next);
+    }
+};
@@ -0,0 +1,249 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <ranges>
+#include <utility>
+
+#include "allocator.h"
+#include "flat_search.h"
+#include "simple_vector.h"
+
+// Упорядоченное множество в отсортированном SimpleVector.
+// Поиск — двоичный без ветвлений или по копии ключей в порядке Эйтцингера (SearchLayout).
+// Одиночная вставка и удаление сдвигают хвост и стоят O(n); для обновлений пачкой
+// есть InsertBatch, который сливает отсортированную пачку с элементами за один проход
+template <typename Key, typename Compare = std::less<Key>, typename Allocator = MallocAllocator<Key>>
+class FlatSet {
+public:
+    using Vector = SimpleVector<Key, Allocator>;
+    // Элементы множества нельзя изменять на месте, поэтому итераторы только константные
+    using Iterator = typename Vector::ConstIterator;
+    using ConstIterator = typename Vector::ConstIterator;
+
+    FlatSet() = default;
+
+    explicit FlatSet(const Compare& comp, const Allocator& alloc = Allocator())
+        : items_(alloc)
+        , index_(comp) {
+    }
+
+    // Строит множество из произвольного вектора: сортирует его и удаляет повторы
+    explicit FlatSet(Vector items, const Compare& comp = Compare())
+        : items_(std::move(items))
+        , index_(comp) {
+        SortAndDeduplicate(items_);
+        Rebuild();
+    }
+
+    // Забирает уже отсортированный вектор без повторов
+    FlatSet(SortedUniqueTag, Vector items, const Compare& comp = Compare())
+        : items_(std::move(items))
+        , index_(comp) {
+        Rebuild();
+    }
+
+    template <std::input_iterator InputIt>
+    FlatSet(InputIt first, InputIt last, const Compare& comp = Compare())
+        : index_(comp) {
+        items_.Append(first, last);
+        SortAndDeduplicate(items_);
+        Rebuild();
+    }
+
+    FlatSet(std::initializer_list<Key> init, const Compare& comp = Compare())
+        : FlatSet(init.begin(), init.end(), comp) {
+    }
+
+    size_t GetSize() const noexcept {
+        return items_.GetSize();
+    }
+
+    bool IsEmpty() const noexcept {
+        return items_.IsEmpty();
+    }
+
+    // Отсортированные элементы множества
+    const Vector& GetVector() const noexcept {
+        return items_;
+    }
+
+    // Забирает отсортированные элементы, оставляя множество пустым
+    Vector Extract() {
+        Vector result(std::move(items_));
+        Rebuild();
+        return result;
+    }
+
+    SearchLayout GetLayout() const noexcept {
+        return index_.GetLayout();
+    }
+
+    void SetLayout(SearchLayout layout) {
+        index_.SetLayout(layout, items_.begin(), items_.GetSize());
+    }
+
+    void Reserve(size_t capacity) {
+        items_.Reserve(capacity);
+    }
+
+    void Clear() {
+        items_.Clear();
+        Rebuild();
+    }
+
+    // Вставляет key, если его ещё нет; возвращает позицию элемента и признак вставки
+    std::pair<Iterator, bool> Insert(const Key& key) {
+        return Emplace(key);
+    }
+
+    std::pair<Iterator, bool> Insert(Key&& key) {
+        return Emplace(std::move(key));
+    }
+
+    // Добавляет элементы диапазона: пачка сортируется отдельно и сливается с множеством за один проход.
+    // Ключи, которые уже есть в множестве, не заменяются
+    template <std::ranges::input_range Range>
+        requires std::ranges::common_range<Range>
+    void InsertBatch(Range&& range) {
+        Vector batch(items_.GetAllocator());
+        batch.Append(std::forward<Range>(range));
+        MergeBatch(std::move(batch));
+    }
+
+    template <std::input_iterator InputIt>
+    void InsertBatch(InputIt first, InputIt last) {
+        Vector batch(items_.GetAllocator());
+        batch.Append(first, last);
+        MergeBatch(std::move(batch));
+    }
+
+    void InsertBatch(std::initializer_list<Key> init) {
+        InsertBatch(init.begin(), init.end());
+    }
+
+    // Удаляет key; возвращает число удалённых элементов
+    size_t Erase(const Key& key) {
+        const size_t index = LowerBoundIndex(key);
+        if (!index_.IsMatch(items_.begin(), items_.GetSize(), index, key)) {
+            return 0;
+        }
+        items_.Erase(items_.begin() + index);
+        Rebuild();
+        return 1;
+    }
+
+    Iterator Erase(ConstIterator pos) {
+        const size_t index = pos - items_.cbegin();
+        items_.Erase(pos);
+        Rebuild();
+        return items_.cbegin() + index;
+    }
+
+    template <typename Other>
+    ConstIterator Find(const Other& key) const {
+        const size_t index = LowerBoundIndex(key);
+        return index_.IsMatch(items_.begin(), items_.GetSize(), index, key) ? items_.cbegin() + index : items_.cend();
+    }
+
+    template <typename Other>
+    bool Contains(const Other& key) const {
+        return index_.IsMatch(items_.begin(), items_.GetSize(), LowerBoundIndex(key), key);
+    }
+
+    template <typename Other>
+    size_t Count(const Other& key) const {
+        return Contains(key) ? 1 : 0;
+    }
+
+    // Первый элемент, не меньший key
+    template <typename Other>
+    ConstIterator LowerBound(const Other& key) const {
+        return items_.cbegin() + LowerBoundIndex(key);
+    }
+
+    // Первый элемент, больший key
+    template <typename Other>
+    ConstIterator UpperBound(const Other& key) const {
+        const size_t index = LowerBoundIndex(key);
+        return items_.cbegin() + index + (index_.IsMatch(items_.begin(), items_.GetSize(), index, key) ? 1 : 0);
+    }
+
+    ConstIterator begin() const noexcept {
+        return items_.cbegin();
+    }
+
+    ConstIterator end() const noexcept {
+        return items_.cend();
+    }
+
+    ConstIterator cbegin() const noexcept {
+        return items_.cbegin();
+    }
+
+    ConstIterator cend() const noexcept {
+        return items_.cend();
+    }
+
+private:
+    Vector items_;
+    FlatSearchIndex<Key, Compare> index_;
+
+    template <typename Other>
+    size_t LowerBoundIndex(const Other& key) const {
+        return index_.LowerBound(items_.begin(), items_.GetSize(), key);
+    }
+
+    void Rebuild() {
+        index_.Rebuild(items_.begin(), items_.GetSize());
+    }
+
+    // Сортирует вектор и оставляет первый из каждой группы эквивалентных ключей
+    void SortAndDeduplicate(Vector& items) const {
+        const Compare& comp = index_.GetCompare();
+        std::stable_sort(items.begin(), items.end(), comp);
+        const auto last = std::unique(items.begin(), items.end(), [&comp](const Key& lhs, const Key& rhs) {
+            return !comp(lhs, rhs);
+        });
+        items.Erase(last, items.end());
+    }
+
+    template <typename Arg>
+    std::pair<Iterator, bool> Emplace(Arg&& key) {
+        const size_t index = LowerBoundIndex(key);
+        if (index_.IsMatch(items_.begin(), items_.GetSize(), index, key)) {
+            return {items_.cbegin() + index, false};
+        }
+        items_.Insert(items_.cbegin() + index, std::forward<Arg>(key));
+        Rebuild();
+        return {items_.cbegin() + index, true};
+    }
+
+    // Пачка дописывается в конец и сливается с элементами; из эквивалентных ключей
+    // остаётся прежний, так как слияние устойчиво
+    void MergeBatch(Vector&& batch) {
+        SortAndDeduplicate(batch);
+        const size_t old_size = items_.GetSize();
+        items_.Append(std::move(batch));
+        const Compare& comp = index_.GetCompare();
+        std::inplace_merge(items_.begin(), items_.begin() + old_size, items_.end(), comp);
+        const auto last = std::unique(items_.begin(), items_.end(), [&comp](const Key& lhs, const Key& rhs) {
+            return !comp(lhs, rhs);
+        });
+        items_.Erase(last, items_.end());
+        Rebuild();
+    }
+};
+
+template <typename Key, typename Compare, typename Allocator>
+bool operator==(const FlatSet<Key, Compare, Allocator>& lhs, const FlatSet<Key, Compare, Allocator>& rhs) {
+    return lhs.GetVector() == rhs.GetVector();
+}
+
+template <typename Key, typename Compare, typename Allocator>
+bool operator!=(const FlatSet<Key, Compare, Allocator>& lhs, const FlatSet<Key, Compare, Allocator>& rhs) {
+    return !(lhs == rhs);
+}
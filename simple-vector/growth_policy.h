@@ -0,0 +1,60 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+
+// Политики роста вместимости SimpleVector.
+// NextCapacity(capacity, required, element_size) возвращает новую вместимость не меньше required,
+// где capacity — текущая вместимость, а required — сколько элементов должно поместиться
+
+// Удваивает вместимость; вектор вместимостью 0 получает ровно required элементов
+struct DoublingGrowth {
+    static size_t NextCapacity(size_t capacity, size_t required, size_t) noexcept {
+        return std::max(required, 2 * capacity);
+    }
+};
+
+// Увеличивает вместимость в полтора раза. Сумма всех прежних блоков со временем
+// превышает размер нового, и аллокатор может собрать его из освобождённой памяти
+struct OneAndHalfGrowth {
+    static size_t NextCapacity(size_t capacity, size_t required, size_t) noexcept {
+        return std::max(required, capacity + capacity / 2);
+    }
+};
+
+// Растёт в полтора раза и округляет размер блока вверх до класса размеров аллокатора,
+// чтобы не оставлять неиспользуемый хвост в блоке, который malloc всё равно выделит.
+// Классы устроены как в jemalloc: четыре класса на каждую степень двойки, не мельче 16 байт
+struct SizeClassGrowth {
+    static size_t RoundToSizeClass(size_t bytes) noexcept {
+        if (bytes <= 16) {
+            return 16;
+        }
+        const size_t power = std::bit_floor(bytes - 1);
+        const size_t step = std::max<size_t>(power / 4, 16);
+        return (bytes + step - 1) / step * step;
+    }
+
+    static size_t NextCapacity(size_t capacity, size_t required, size_t element_size) noexcept {
+        const size_t target = OneAndHalfGrowth::NextCapacity(capacity, required, element_size);
+        return std::max(target, RoundToSizeClass(target * element_size) / element_size);
+    }
+};
+
+// Удваивает вместимость, а блоки от страницы и больше округляет вверх до целого числа страниц:
+// крупные блоки malloc берёт у ОС страницами, и остаток страницы иначе пропадает
+template <size_t PageSize = 4096>
+struct PageGrowth {
+    static_assert(std::has_single_bit(PageSize), "page size must be a power of two");
+
+    static size_t NextCapacity(size_t capacity, size_t required, size_t element_size) noexcept {
+        const size_t target = DoublingGrowth::NextCapacity(capacity, required, element_size);
+        const size_t bytes = target * element_size;
+        if (bytes < PageSize) {
+            return target;
+        }
+        const size_t page_bytes = (bytes + PageSize - 1) / PageSize * PageSize;
+        return page_bytes / element_size;
+    }
+};
@@ -1,9 +1,41 @@
+#include "buffer_cache.h"
+#include "compressed_vector.h"
+#include "concurrent_vector.h"
+#include "cow_simple_vector.h"
+#include "flat_map.h"
+#include "flat_set.h"
+#include "memory_resources.h"
+#include "mmap_allocator.h"
+#include "parallel.h"
+#include "ring_buffer.h"
+#include "serialization.h"
+#include "simple_devector.h"
 #include "simple_vector.h"
+#include "small_simple_vector.h"
+#include "soa_simple_vector.h"
+#include "sort.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <fstream>
 #include <iostream>
+#include <map>
+#include <memory>
 #include <numeric>
+#include <random>
+#include <set>
+#include <span>
+#include <sstream>
 #include <string>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
 
 using namespace std;
 
@@ -32,6 +64,195 @@ private:
     size_t x_;
 };
 
+// Тип без конструктора по умолчанию, считающий живые экземпляры
+class Counted {
+public:
+    explicit Counted(int value)
+        : value_(value) {
+        ++alive;
+    }
+    Counted(const Counted& other)
+        : value_(other.value_) {
+        ++alive;
+    }
+    Counted& operator=(const Counted& other) {
+        if (fail_assignment) {
+            throw runtime_error("assignment");
+        }
+        value_ = other.value_;
+        return *this;
+    }
+    ~Counted() {
+        --alive;
+    }
+    int GetValue() const {
+        return value_;
+    }
+
+    static inline int alive = 0;
+    // Заставляет присваивание бросать исключение: проверка безопасности сдвигов
+    static inline bool fail_assignment = false;
+
+private:
+    int value_;
+};
+
+// Владеющий тип, подтверждающий тривиальную перемещаемость специализацией
+struct Handle {
+    Handle() = default;
+    Handle(int value)
+        : ptr(make_unique<int>(value)) {
+    }
+    unique_ptr<int> ptr;
+};
+
+template <>
+struct IsTriviallyRelocatable<Handle> : std::true_type {
+};
+
+// Тип, который больше нигде не хранится в SimpleVector: его статистика принадлежит одному тесту
+struct StatsProbe {
+    int value = 0;
+};
+
+// Число операций над элементами Instrumented и выделений памяти CountingAllocator с последней проверки
+struct OperationCounts {
+    int default_constructions = 0;
+    int value_constructions = 0;
+    int copies = 0;
+    int copy_assignments = 0;
+    int moves = 0;
+    int move_assignments = 0;
+    int destructions = 0;
+    int allocations = 0;
+    int deallocations = 0;
+
+    bool operator==(const OperationCounts&) const = default;
+};
+
+OperationCounts operation_counts;
+
+// Проверяет, что с прошлой проверки выполнены ровно операции expected, и обнуляет счётчики
+void ExpectOperations(const OperationCounts& expected) {
+    assert(operation_counts == expected);
+    operation_counts = {};
+}
+
+// Элемент, считающий каждую операцию над собой в operation_counts.
+// NothrowMove = false заставляет вектор переносить элементы копированием,
+// Relocatable = true подтверждает тривиальную перемещаемость (см. специализацию ниже)
+template <bool NothrowMove = true, bool Relocatable = false>
+class Instrumented {
+public:
+    Instrumented() {
+        ++operation_counts.default_constructions;
+    }
+    explicit Instrumented(int value)
+        : value_(value) {
+        ++operation_counts.value_constructions;
+    }
+    Instrumented(const Instrumented& other)
+        : value_(other.value_) {
+        ++operation_counts.copies;
+    }
+    Instrumented(Instrumented&& other) noexcept(NothrowMove)
+        : value_(exchange(other.value_, -1)) {
+        ++operation_counts.moves;
+    }
+    Instrumented& operator=(const Instrumented& other) {
+        value_ = other.value_;
+        ++operation_counts.copy_assignments;
+        return *this;
+    }
+    Instrumented& operator=(Instrumented&& other) noexcept(NothrowMove) {
+        value_ = exchange(other.value_, -1);
+        ++operation_counts.move_assignments;
+        return *this;
+    }
+    ~Instrumented() {
+        ++operation_counts.destructions;
+    }
+    int GetValue() const {
+        return value_;
+    }
+    bool operator==(const Instrumented& other) const {
+        return value_ == other.value_;
+    }
+    bool operator<(const Instrumented& other) const {
+        return value_ < other.value_;
+    }
+
+private:
+    int value_ = 0;
+};
+
+template <bool NothrowMove>
+struct IsTriviallyRelocatable<Instrumented<NothrowMove, true>> : std::true_type {
+};
+
+// Аллокатор, считающий выделения и освобождения в operation_counts.
+// Метода reallocate нет, поэтому каждое перевыделение видно как пара allocate/deallocate
+template <typename Type>
+class CountingAllocator {
+public:
+    using value_type = Type;
+    using is_always_equal = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    CountingAllocator() noexcept = default;
+
+    template <typename Other>
+    CountingAllocator(const CountingAllocator<Other>&) noexcept {
+    }
+
+    Type* allocate(size_t size) {
+        ++operation_counts.allocations;
+        return MallocAllocator<Type>().allocate(size);
+    }
+
+    void deallocate(Type* ptr, size_t size) noexcept {
+        ++operation_counts.deallocations;
+        MallocAllocator<Type>().deallocate(ptr, size);
+    }
+
+    bool operator==(const CountingAllocator&) const noexcept {
+        return true;
+    }
+};
+
+template <typename Type>
+using CostVector = SimpleVector<Type, CountingAllocator<Type>>;
+
+// Считающий аллокатор с номером арены: аллокаторы разных арен не равны и не переходят между векторами
+template <typename Type>
+class ArenaCountingAllocator : public CountingAllocator<Type> {
+public:
+    using is_always_equal = std::false_type;
+    using propagate_on_container_move_assignment = std::false_type;
+    using propagate_on_container_swap = std::false_type;
+
+    explicit ArenaCountingAllocator(int arena = 0) noexcept
+        : arena_(arena) {
+    }
+
+    template <typename Other>
+    ArenaCountingAllocator(const ArenaCountingAllocator<Other>& other) noexcept
+        : arena_(other.GetArena()) {
+    }
+
+    int GetArena() const noexcept {
+        return arena_;
+    }
+
+    bool operator==(const ArenaCountingAllocator& other) const noexcept {
+        return arena_ == other.arena_;
+    }
+
+private:
+    int arena_;
+};
+
 SimpleVector<int> GenerateVector(size_t size) {
     SimpleVector<int> v(size);
     iota(v.begin(), v.end(), 1);
@@ -150,6 +371,2113 @@ void TestNoncopiableErase() {
     cout << "Done!"s << endl << endl;
 }
 
+void TestReserveConstructsNothing() {
+    cout << "Test reserve without constructing elements"s << endl;
+    {
+        SimpleVector<Counted> v(Reserve(1000000));
+        assert(v.GetCapacity() == 1000000);
+        assert(Counted::alive == 0);
+
+        for (int i = 0; i < 10; ++i) {
+            v.EmplaceBack(i);
+        }
+        assert(Counted::alive == 10);
+
+        v.PopBack();
+        assert(Counted::alive == 9);
+        v.Erase(v.begin());
+        assert(Counted::alive == 8 && v[0].GetValue() == 1);
+        v.Clear();
+        assert(Counted::alive == 0);
+        assert(v.GetCapacity() == 1000000);
+
+        v.PushBack(Counted(7));
+        assert(Counted::alive == 1);
+    }
+    assert(Counted::alive == 0);
+    cout << "Done!"s << endl << endl;
+}
+
+void TestEmplace() {
+    cout << "Test emplace"s << endl;
+    {
+        SimpleVector<Counted> v;
+        for (int i = 0; i < 5; ++i) {
+            v.EmplaceBack(i);
+        }
+        // в начало, с переносом в новую память
+        auto it = v.Emplace(v.begin(), 10);
+        assert(it == v.begin() && it->GetValue() == 10);
+        assert(v.GetSize() == 6 && v.GetCapacity() == 8);
+        // в середину, без переноса
+        it = v.Emplace(v.begin() + 3, 11);
+        assert(it->GetValue() == 11);
+        assert(v[2].GetValue() == 1 && v[4].GetValue() == 2);
+        // в конец
+        it = v.Emplace(v.end(), 12);
+        assert((v.end() - 1)->GetValue() == 12);
+        assert(Counted::alive == 8);
+
+        // аргумент ссылается на элемент самого вектора
+        v.PushBack(v[0]);
+        assert(v.GetSize() == 9 && v[8].GetValue() == 10);
+        v.Insert(v.begin(), v[8]);
+        assert(v[0].GetValue() == 10);
+
+        v.Erase(v.begin());
+        assert(v.GetSize() == 9 && Counted::alive == 9);
+    }
+    assert(Counted::alive == 0);
+
+    {
+        // Исключение при сдвиге: уже сконструированный в конце элемент остаётся во владении вектора
+        SimpleVector<Counted> v(Reserve(4));
+        for (int i = 0; i < 3; ++i) {
+            v.EmplaceBack(i);
+        }
+        Counted::fail_assignment = true;
+        try {
+            v.Emplace(v.begin(), 10);
+            assert(false);
+        }
+        catch (const runtime_error&) {
+        }
+        Counted::fail_assignment = false;
+        assert(v.GetSize() == 4 && Counted::alive == 4);
+    }
+    assert(Counted::alive == 0);
+    cout << "Done!"s << endl << endl;
+}
+
+void TestResizeDestroysTail() {
+    cout << "Test resize destroys tail"s << endl;
+    SimpleVector<string> v(3, "abc"s);
+    v.Resize(1);
+    assert(v.GetSize() == 1 && v.GetCapacity() == 3);
+    v.Resize(3);
+    assert(v[0] == "abc"s && v[1].empty() && v[2].empty());
+    v.Resize(7);
+    assert(v.GetSize() == 7 && v.GetCapacity() == 7);
+    v.Resize(8);
+    assert(v.GetCapacity() == 14 && v[7].empty());
+    cout << "Done!"s << endl << endl;
+}
+
+void TestTriviallyRelocatable() {
+    cout << "Test trivially relocatable types"s << endl;
+    static_assert(is_trivially_relocatable_v<int>);
+    static_assert(!is_trivially_relocatable_v<string>);
+    {
+        SimpleVector<int> v;
+        for (int i = 0; i < 100; ++i) {
+            v.PushBack(i);
+        }
+        v.Insert(v.begin(), -1);
+        v.Insert(v.begin() + 50, -2);
+        v.Insert(v.end(), -3);
+        assert(v.GetSize() == 103 && v.GetCapacity() == 128);
+        assert(v[0] == -1 && v[1] == 0 && v[50] == -2 && v[51] == 49 && v[102] == -3);
+        v.Erase(v.begin() + 50);
+        v.Erase(v.begin());
+        assert(v[0] == 0 && v[49] == 49 && v[50] == 50);
+        v.PushBack(v[0]);
+        assert(v[v.GetSize() - 1] == 0);
+    }
+    {
+        SimpleVector<Handle> v;
+        for (int i = 0; i < 10; ++i) {
+            v.EmplaceBack(i);
+        }
+        v.Emplace(v.begin() + 3, 100);
+        v.Erase(v.begin());
+        v.Resize(20);
+        assert(*v[0].ptr == 1 && *v[2].ptr == 100 && *v[9].ptr == 9 && !v[10].ptr);
+    }
+    cout << "Done!"s << endl << endl;
+}
+
+void TestPmrAllocator() {
+    cout << "Test pmr allocator"s << endl;
+    MonotonicArena arena;
+    {
+        PmrSimpleVector<string> v(&arena);
+        for (int i = 0; i < 100; ++i) {
+            v.PushBack(to_string(i));
+        }
+        v.Insert(v.begin(), "first"s);
+        assert(v.GetAllocator().resource() == &arena);
+        assert(arena.GetBytesAllocated() >= v.GetCapacity() * sizeof(string));
+
+        // копия берёт ресурс по умолчанию, присваивание сохраняет ресурс левого операнда
+        PmrSimpleVector<string> copy(v);
+        assert(copy == v);
+        assert(copy.GetAllocator().resource() == pmr::get_default_resource());
+        PmrSimpleVector<string> assigned(&arena);
+        assigned = copy;
+        assert(assigned == v && assigned.GetAllocator().resource() == &arena);
+
+        // перемещение между разными ресурсами переносит элементы поштучно
+        MonotonicArena other_arena;
+        PmrSimpleVector<string> moved(&other_arena);
+        moved = move(v);
+        assert(moved == copy && v.IsEmpty());
+        assert(moved.GetAllocator().resource() == &other_arena);
+
+        PmrSimpleVector<string> same(&arena);
+        same = move(assigned);
+        assert(same == copy && assigned.IsEmpty());
+        same.swap(assigned);
+        assert(assigned == copy && same.IsEmpty());
+    }
+    arena.Release();
+    assert(arena.GetBytesAllocated() == 0);
+    cout << "Done!"s << endl << endl;
+}
+
+void TestSizeClassPool() {
+    cout << "Test size class pool"s << endl;
+    SizeClassPool pool;
+    const int* first_data = nullptr;
+    {
+        PmrSimpleVector<int> v(Reserve(8), &pool);
+        v.PushBack(1);
+        first_data = v.begin();
+    }
+    {
+        // освобождённый блок того же класса переиспользуется
+        PmrSimpleVector<int> v(Reserve(7), &pool);
+        assert(v.begin() == first_data);
+        for (int i = 0; i < 10000; ++i) {
+            v.PushBack(i);
+        }
+        assert(v[9999] == 9999);
+    }
+    cout << "Done!"s << endl << endl;
+}
+
+void TestSmallSimpleVector() {
+    cout << "Test small simple vector"s << endl;
+    {
+        SmallSimpleVector<string, 4> v;
+        assert(v.IsInline() && v.GetCapacity() == 4);
+        for (int i = 0; i < 4; ++i) {
+            v.PushBack(to_string(i));
+        }
+        assert(v.IsInline());
+        v.Insert(v.begin(), "x"s);
+        assert(!v.IsInline() && v.GetCapacity() == 8 && v.GetSize() == 5);
+        assert(v[0] == "x"s && v[4] == "3"s);
+        v.Erase(v.begin() + 1);
+        v.Resize(2);
+        assert((v == SmallSimpleVector<string, 4>{"x"s, "1"s}));
+        assert((v < SmallSimpleVector<string, 4>{"y"s}));
+    }
+    {
+        // перемещение и обмен во всех сочетаниях встроенного буфера и кучи
+        SmallSimpleVector<string, 2> small{"a"s, "b"s};
+        SmallSimpleVector<string, 2> big{"1"s, "2"s, "3"s};
+        SmallSimpleVector<string, 2> tiny{"t"s};
+        assert(small.IsInline() && !big.IsInline());
+
+        small.swap(big);
+        assert(!small.IsInline() && small.GetSize() == 3 && small[2] == "3"s);
+        assert(big.IsInline() && big.GetSize() == 2 && big[1] == "b"s);
+        tiny.swap(big);
+        assert(tiny.GetSize() == 2 && tiny[0] == "a"s && big.GetSize() == 1 && big[0] == "t"s);
+
+        SmallSimpleVector<string, 2> moved_inline(move(tiny));
+        assert(moved_inline.IsInline() && moved_inline[1] == "b"s && tiny.IsEmpty());
+        SmallSimpleVector<string, 2> moved_heap(move(small));
+        assert(!moved_heap.IsInline() && moved_heap[0] == "1"s);
+        assert(small.IsEmpty() && small.IsInline() && small.GetCapacity() == 2);
+
+        moved_heap = moved_inline;
+        assert(moved_heap == moved_inline && moved_heap.IsInline());
+        moved_inline = SmallSimpleVector<string, 2>(5, "z"s);
+        assert(!moved_inline.IsInline() && moved_inline.GetSize() == 5);
+    }
+    {
+        SmallSimpleVector<X, 2> v;
+        for (size_t i = 0; i < 5; ++i) {
+            v.PushBack(X(i));
+        }
+        SmallSimpleVector<X, 2> moved(move(v));
+        assert(moved.GetSize() == 5 && moved[4].GetX() == 4);
+    }
+    {
+        // Исключение при сдвиге во встроенном буфере не теряет элемент, сконструированный в конце
+        SmallSimpleVector<Counted, 4> v;
+        for (int i = 0; i < 3; ++i) {
+            v.EmplaceBack(i);
+        }
+        Counted::fail_assignment = true;
+        try {
+            v.Emplace(v.begin(), 10);
+            assert(false);
+        }
+        catch (const runtime_error&) {
+        }
+        Counted::fail_assignment = false;
+        assert(v.IsInline() && v.GetSize() == 4 && Counted::alive == 4);
+    }
+    assert(Counted::alive == 0);
+    cout << "Done!"s << endl << endl;
+}
+
+void TestGrowthPolicies() {
+    cout << "Test growth policies"s << endl;
+    {
+        SimpleVector<int, MallocAllocator<int>, OneAndHalfGrowth> v;
+        SimpleVector<size_t> capacities;
+        for (int i = 0; i < 20; ++i) {
+            v.PushBack(i);
+            if (capacities.IsEmpty() || capacities[capacities.GetSize() - 1] != v.GetCapacity()) {
+                capacities.PushBack(v.GetCapacity());
+            }
+        }
+        assert((capacities == SimpleVector<size_t>{1, 2, 3, 4, 6, 9, 13, 19, 28}));
+    }
+    {
+        SimpleVector<int, MallocAllocator<int>, SizeClassGrowth> v;
+        for (int i = 0; i < 1000; ++i) {
+            v.PushBack(i);
+            const size_t bytes = v.GetCapacity() * sizeof(int);
+            assert(SizeClassGrowth::RoundToSizeClass(bytes) == bytes);
+        }
+        assert(v[999] == 999);
+    }
+    {
+        SimpleVector<double, MallocAllocator<double>, PageGrowth<>> v;
+        v.Resize(1000);
+        assert(v.GetCapacity() == 1024);
+        v.Resize(1025);
+        assert(v.GetCapacity() == 2048);
+        v.Resize(3000);
+        assert(v.GetCapacity() * sizeof(double) % 4096 == 0 && v.GetCapacity() >= 4096);
+    }
+    cout << "Done!"s << endl << endl;
+}
+
+void TestShrinkToFit() {
+    cout << "Test shrink to fit"s << endl;
+    SimpleVector<string> v(Reserve(100));
+    v.PushBack("a"s);
+    v.PushBack("b"s);
+    v.ShrinkToFit();
+    assert(v.GetCapacity() == 2 && v[1] == "b"s);
+    v.Clear();
+    v.ShrinkToFit();
+    assert(v.GetCapacity() == 0 && v.begin() == nullptr);
+    v.PushBack("c"s);
+    assert(v.GetCapacity() == 1);
+
+    SimpleVector<int> ints(1000, 1);
+    ints.Resize(10);
+    ints.ShrinkToFit();
+    assert(ints.GetCapacity() == 10 && ints[9] == 1);
+    cout << "Done!"s << endl << endl;
+}
+
+void TestVectorStats() {
+    cout << "Test vector stats"s << endl;
+    using ProbeVector = SimpleVector<StatsProbe>;
+    {
+        ProbeVector v;
+        for (int i = 0; i < 5; ++i) {
+            v.PushBack({i});
+        }
+        v.Insert(v.begin(), {-1});
+        ProbeVector reserved(Reserve(10));
+        reserved.Resize(10);
+    }
+    const VectorStatsSnapshot stats = VectorStats<ProbeVector>::Get();
+    if constexpr (kVectorStatsEnabled) {
+        // вместимость 1, 2, 4, 8 при PushBack и 10 при Reserve
+        assert(stats.allocations == 5);
+        assert(stats.bytes_allocated == (1 + 2 + 4 + 8 + 10) * sizeof(StatsProbe));
+        assert(stats.GetRelocations(RelocationSite::kPushBack) == 3);
+        assert(stats.GetRelocations(RelocationSite::kInsert) == 0);
+        assert(stats.GetRelocations(RelocationSite::kReserve) == 0);
+        assert(stats.elements_moved == 1 + 2 + 4 && stats.elements_copied == 0);
+        assert(stats.peak_capacity == 10);
+        // размеры 6 и 10 попадают в корзины [4, 8) и [8, 16)
+        assert(stats.destroyed_sizes[3] == 1 && stats.destroyed_sizes[4] == 1);
+        assert(stats.type_name.find("StatsProbe"s) != string::npos);
+        DumpVectorStats(cout);
+    }
+    else {
+        assert(stats.allocations == 0 && stats.type_name.empty());
+    }
+    cout << "Done!"s << endl << endl;
+}
+
+void TestRangeInsert() {
+    cout << "Test range insert"s << endl;
+    const vector<int> source{10, 11, 12};
+    {
+        SimpleVector<int> v{1, 2, 3, 4};
+        // с перевыделением памяти
+        auto it = v.Insert(v.begin() + 1, source.begin(), source.end());
+        assert(it == v.begin() + 1);
+        assert((v == SimpleVector<int>{1, 10, 11, 12, 2, 3, 4}));
+        assert(v.GetCapacity() == 8);
+        // без перевыделения
+        v.Insert(v.end(), {20});
+        v.Insert(v.begin(), 0, 7);
+        assert((v == SimpleVector<int>{1, 10, 11, 12, 2, 3, 4, 20}));
+        // значение из самого вектора
+        v.Insert(v.begin(), 2, v[7]);
+        assert((v == SimpleVector<int>{20, 20, 1, 10, 11, 12, 2, 3, 4, 20}));
+    }
+    {
+        // хвост длиннее вставки и хвост короче вставки
+        SimpleVector<string> v{"a"s, "b"s, "c"s, "d"s};
+        v.Reserve(20);
+        v.Insert(v.begin() + 1, {"x"s, "y"s});
+        assert((v == SimpleVector<string>{"a"s, "x"s, "y"s, "b"s, "c"s, "d"s}));
+        v.Insert(v.end() - 1, {"1"s, "2"s, "3"s});
+        assert((v == SimpleVector<string>{"a"s, "x"s, "y"s, "b"s, "c"s, "1"s, "2"s, "3"s, "d"s}));
+        v.Insert(v.begin() + 2, 3, "z"s);
+        assert(v.GetSize() == 12 && v[2] == "z"s && v[4] == "z"s && v[5] == "y"s && v.GetCapacity() == 20);
+    }
+    {
+        // однопроходный диапазон
+        istringstream input("5 6 7"s);
+        SimpleVector<int> v{1, 2};
+        v.Insert(v.begin() + 1, istream_iterator<int>(input), istream_iterator<int>());
+        assert((v == SimpleVector<int>{1, 5, 6, 7, 2}));
+    }
+    cout << "Done!"s << endl << endl;
+}
+
+void TestAppendAndRangeErase() {
+    cout << "Test append and range erase"s << endl;
+    {
+        SimpleVector<string> v{"a"s};
+        vector<string> batch{"b"s, "c"s};
+        v.Append(batch);
+        assert(batch[0] == "b"s);
+        v.Append(move(batch));
+        assert(batch[0].empty());
+        v.Append({"d"s});
+        assert((v == SimpleVector<string>{"a"s, "b"s, "c"s, "b"s, "c"s, "d"s}));
+
+        auto it = v.Erase(v.begin() + 1, v.begin() + 3);
+        assert(*it == "b"s);
+        assert((v == SimpleVector<string>{"a"s, "b"s, "c"s, "d"s}));
+        it = v.Erase(v.begin() + 2, v.end());
+        assert(it == v.end() && v.GetSize() == 2);
+        v.Erase(v.begin(), v.begin());
+        assert(v.GetSize() == 2);
+    }
+    {
+        SimpleVector<X> v;
+        vector<X> batch;
+        for (size_t i = 0; i < 3; ++i) {
+            batch.push_back(X(i));
+        }
+        v.Append(move(batch));
+        for (size_t i = 0; i < 3; ++i) {
+            batch[i] = X(10 + i);
+        }
+        v.Append(make_move_iterator(batch.begin()), make_move_iterator(batch.end()));
+        assert(v.GetSize() == 6);
+        for (size_t i = 0; i < 6; ++i) {
+            assert(v[i].GetX() == (i < 3 ? i : 7 + i));
+        }
+        assert(batch[0].GetX() == 0);
+        v.Erase(v.begin(), v.begin() + 2);
+        assert(v.GetSize() == 4 && v[0].GetX() == 2 && v[1].GetX() == 10);
+    }
+    {
+        SimpleVector<int> v(10);
+        iota(v.begin(), v.end(), 0);
+        v.Erase(v.begin() + 2, v.begin() + 8);
+        assert((v == SimpleVector<int>{0, 1, 8, 9}));
+    }
+    cout << "Done!"s << endl << endl;
+}
+
+void TestParallelBulkOperations() {
+    cout << "Test parallel bulk operations"s << endl;
+    // Низкий порог, чтобы параллельный путь сработал на векторах умеренного размера
+    ParallelExecution::Enable(3, 1024);
+    const size_t size = 1 << 20;
+    {
+        SimpleVector<int> filled(size, 7);
+        assert(all_of(filled.begin(), filled.end(), [](int x) {
+            return x == 7;
+        }));
+
+        SimpleVector<int> v(size);
+        assert(all_of(v.begin(), v.end(), [](int x) {
+            return x == 0;
+        }));
+        iota(v.begin(), v.end(), 0);
+
+        SimpleVector<int> copy(v);
+        assert(copy == v && !(copy < v) && !(copy > v) && copy <= v);
+        for (size_t pos : {size_t{0}, size / 3, size / 2, size - 1}) {
+            ++copy[pos];
+            assert(copy != v && v < copy && copy > v);
+            --copy[pos];
+        }
+        // Различие в начале решает исход, даже если дальше есть обратное
+        --copy[size - 1];
+        ++copy[10];
+        assert(v < copy);
+
+        copy.Resize(size * 2);
+        assert(copy[size * 2 - 1] == 0 && copy[size - 2] == static_cast<int>(size - 2));
+        assert(v < copy);
+        copy.Resize(size);
+        ++copy[10];
+        copy.PushBack(0);
+        assert(v < copy);
+    }
+    {
+        // Несравнимые значения эквивалентны для лексикографического сравнения, но не равны
+        SimpleVector<double> lhs(size, 1.0);
+        SimpleVector<double> rhs(lhs);
+        lhs[size / 2] = nan("");
+        assert(lhs != rhs && !(lhs < rhs) && !(rhs < lhs));
+        rhs[size - 1] = 2.0;
+        assert(lhs < rhs);
+    }
+    {
+        SimpleVector<string> lhs(size / 16, "value"s);
+        SimpleVector<string> rhs(lhs);
+        assert(lhs == rhs);
+        rhs[rhs.GetSize() - 1] = "values"s;
+        assert(lhs < rhs);
+    }
+    ParallelExecution::Disable();
+    cout << "Done!"s << endl << endl;
+}
+
+// Сравнивает результаты операторов SimpleVector с std::vector для векторов с различием в каждой позиции
+template <typename Type>
+void CheckSimdCompare() {
+    for (size_t size : {size_t{0}, size_t{1}, size_t{7}, size_t{31}, size_t{64}, size_t{130}}) {
+        SimpleVector<Type> lhs(size);
+        iota(lhs.begin(), lhs.end(), Type{1});
+        for (size_t pos = 0; pos <= size; ++pos) {
+            SimpleVector<Type> rhs(lhs);
+            if (pos < size) {
+                rhs[pos] = Type{0};
+            }
+            else {
+                rhs.PushBack(Type{0});
+            }
+            const vector<Type> l(lhs.begin(), lhs.end());
+            const vector<Type> r(rhs.begin(), rhs.end());
+            assert((lhs == rhs) == (l == r) && (lhs == lhs));
+            assert((lhs < rhs) == (l < r) && (rhs < lhs) == (r < l));
+        }
+    }
+}
+
+void TestSimdCompare() {
+    cout << "Test SIMD compare"s << endl;
+    const SimdLevel initial = SimdCompare::GetLevel();
+    for (SimdLevel level : {SimdLevel::kScalar, SimdLevel::kSse2, SimdLevel::kAvx2}) {
+        SimdCompare::SetLevel(level);
+        CheckSimdCompare<uint8_t>();
+        CheckSimdCompare<int16_t>();
+        CheckSimdCompare<int>();
+        CheckSimdCompare<uint64_t>();
+        CheckSimdCompare<float>();
+        CheckSimdCompare<double>();
+        {
+            SimpleVector<float> lhs(100, 1.0f);
+            SimpleVector<float> rhs(lhs);
+            lhs[70] = nanf("");
+            assert(lhs != rhs && !(lhs < rhs) && !(rhs < lhs));
+            lhs[70] = -0.0f;
+            rhs[70] = 0.0f;
+            assert(lhs == rhs);
+        }
+        {
+            SmallSimpleVector<int, 4> lhs{1, 2, 3, 4, 5};
+            SmallSimpleVector<int, 4> rhs{1, 2, 3, 4, 6};
+            assert(lhs != rhs && lhs < rhs);
+        }
+    }
+    SimdCompare::SetLevel(initial);
+    cout << "Done!"s << endl << endl;
+}
+
+void TestMmapAllocator() {
+    cout << "Test mmap allocator"s << endl;
+    {
+        MmapSimpleVector<int> v;
+        for (int i = 0; i < 1'000'000; ++i) {
+            v.PushBack(i);
+        }
+        // Вместимость занимает целые страницы
+        assert(v.GetCapacity() * sizeof(int) % MmapAllocator<int>::GetGranularity() == 0);
+        for (int i = 0; i < 1'000'000; ++i) {
+            assert(v[i] == i);
+        }
+        v.Resize(10);
+        v.ShrinkToFit();
+        assert(v.GetCapacity() == 10 && v[9] == 9);
+    }
+    {
+        MmapSimpleVector<uint64_t, true> v(Reserve(1000));
+        iota(v.begin(), v.end(), 0);
+        v.Resize(5'000'000);
+        assert((reinterpret_cast<uintptr_t>(v.begin()) % MmapAllocator<uint64_t, true>::kHugePageSize == 0));
+        v[4'999'999] = 42;
+        MmapSimpleVector<uint64_t, true> copy(v);
+        assert(copy == v);
+    }
+    {
+        // Типы, которые нельзя перенести побайтно, переезжают поэлементно
+        SimpleVector<string, MmapAllocator<string>> v;
+        for (size_t i = 0; i < 2000; ++i) {
+            v.PushBack(to_string(i));
+        }
+        assert(v[1999] == "1999"s);
+    }
+    {
+        MmapAllocator<char> alloc;
+        char* ptr = alloc.allocate(10);
+        ptr[9] = 'x';
+        ptr = alloc.reallocate(ptr, 10, 1 << 24);
+        assert(ptr[9] == 'x');
+        ptr[(1 << 24) - 1] = 'y';
+        ptr = alloc.reallocate(ptr, 1 << 24, 100);
+        assert(ptr[9] == 'x');
+        alloc.deallocate(ptr, 100);
+    }
+    cout << "Done!"s << endl << endl;
+}
+
+// Поток только для последовательного чтения: позиционирование не поддерживается, как у канала
+class ForwardOnlyBuffer : public streambuf {
+public:
+    explicit ForwardOnlyBuffer(const string& data) {
+        char* begin = const_cast<char*>(data.data());
+        setg(begin, begin, begin + data.size());
+    }
+};
+
+void TestBinarySerialization() {
+    cout << "Test binary serialization"s << endl;
+    struct Point {
+        int32_t x;
+        double y;
+    };
+    SimpleVector<Point> points;
+    for (int i = 0; i < 1000; ++i) {
+        points.PushBack({i, i * 0.5});
+    }
+    {
+        stringstream stream;
+        WriteBinary(stream, points);
+        const auto loaded = ReadBinary<Point>(stream);
+        assert(loaded.GetSize() == points.GetSize() && loaded.GetCapacity() == points.GetSize());
+        assert(loaded[999].x == 999 && loaded[999].y == 499.5);
+
+        // Другой тип с тем же размером элементов не читается
+        stream.seekg(0);
+        bool thrown = false;
+        try {
+            ReadBinary<int64_t>(stream);
+        }
+        catch (const SerializationError&) {
+            thrown = true;
+        }
+        assert(thrown);
+    }
+    {
+        stringstream stream;
+        WriteBinary(stream, SimpleVector<int>());
+        assert(ReadBinary<int>(stream).IsEmpty());
+    }
+    {
+        // Число элементов в заголовке не больше данных потока: огромное значение не приводит к выделению памяти
+        stringstream source;
+        WriteBinary(source, points);
+        const string bytes = source.str();
+        auto read_with_count = [&bytes](uint64_t count, bool seekable) {
+            string patched = bytes;
+            memcpy(patched.data() + offsetof(BinaryVectorHeader, count), &count, sizeof(count));
+            ForwardOnlyBuffer buffer(patched);
+            istringstream seekable_stream(patched);
+            istream forward_stream(&buffer);
+            try {
+                ReadBinary<Point>(seekable ? static_cast<istream&>(seekable_stream) : forward_stream);
+            }
+            catch (const SerializationError&) {
+                return true;
+            }
+            return false;
+        };
+        for (bool seekable : {true, false}) {
+            assert(!read_with_count(1000, seekable));
+            assert(read_with_count(1001, seekable));
+            assert(read_with_count(uint64_t{1} << 40, seekable));
+            assert(read_with_count(numeric_limits<uint64_t>::max(), seekable));
+        }
+        ForwardOnlyBuffer buffer(bytes);
+        istream forward_stream(&buffer);
+        assert(ReadBinary<Point>(forward_stream)[999].x == 999);
+    }
+
+    const string path = (filesystem::temp_directory_path() / "simple_vector_serialization_test.bin").string();
+    SaveBinaryFile(path, points);
+    assert(LoadBinaryFile<Point>(path).GetSize() == 1000);
+    {
+        SimpleVectorView<Point> view(path);
+        assert(view.GetSize() == 1000 && !view.IsEmpty());
+        assert(view[10].x == 10 && view.At(999).y == 499.5);
+        assert(distance(view.begin(), view.end()) == 1000);
+        bool thrown = false;
+        try {
+            view.At(1000);
+        }
+        catch (const out_of_range&) {
+            thrown = true;
+        }
+        assert(thrown);
+
+        SimpleVectorView<Point> moved(move(view));
+        assert(view.IsEmpty() && moved.GetSize() == 1000);
+    }
+    {
+        // Повреждённые данные обнаруживаются по контрольной сумме
+        fstream file(path, ios::in | ios::out | ios::binary);
+        const auto position = static_cast<streamoff>(kBinaryVectorHeaderSize + offsetof(Point, y));
+        file.seekg(position);
+        const char byte = static_cast<char>(file.get());
+        file.seekp(position);
+        file.put(static_cast<char>(~byte));
+    }
+    bool thrown = false;
+    try {
+        SimpleVectorView<Point> view(path);
+    }
+    catch (const SerializationError&) {
+        thrown = true;
+    }
+    assert(thrown);
+    assert(SimpleVectorView<Point>(path, ChecksumCheck::kSkip).GetSize() == 1000);
+    filesystem::remove(path);
+    cout << "Done!"s << endl << endl;
+}
+
+void TestConcurrentVector() {
+    cout << "Test concurrent vector"s << endl;
+    const size_t threads = 8;
+    const size_t per_thread = 20'000;
+    {
+        ConcurrentVector<size_t> v;
+        v.PushBack(0);
+        const size_t* first = &v[0];
+        atomic<bool> done = false;
+        // Читатель одновременно проверяет уже опубликованные элементы
+        thread reader([&] {
+            while (!done.load()) {
+                const size_t size = v.GetSize();
+                for (size_t i = 0; i < size; i += 97) {
+                    assert(v[i] < threads * per_thread);
+                }
+            }
+        });
+        vector<thread> writers;
+        for (size_t t = 0; t < threads; ++t) {
+            writers.emplace_back([&v, t] {
+                for (size_t i = 1; i <= per_thread; ++i) {
+                    if (i % 2 == 0) {
+                        v.PushBack(t * per_thread + i - 1);
+                    }
+                    else {
+                        assert(v.EmplaceBack(t * per_thread + i - 1) == t * per_thread + i - 1);
+                    }
+                }
+            });
+        }
+        for (thread& writer : writers) {
+            writer.join();
+        }
+        done = true;
+        reader.join();
+
+        assert(v.GetSize() == threads * per_thread + 1 && &v[0] == first);
+        SimpleVector<size_t> snapshot = v.Snapshot();
+        assert(snapshot.GetSize() == v.GetSize() && snapshot[1000] == v[1000]);
+        sort(snapshot.begin() + 1, snapshot.end());
+        for (size_t i = 1; i < snapshot.GetSize(); ++i) {
+            assert(snapshot[i] == i - 1);
+        }
+    }
+    {
+        ConcurrentVector<string> v;
+        v.Reserve(100);
+        for (size_t i = 0; i < 100; ++i) {
+            v.EmplaceBack(3, 'a' + static_cast<char>(i % 26));
+        }
+        assert(v.At(27) == "bbb"s);
+        SimpleVector<string> drained = v.Drain();
+        assert(drained.GetSize() == 100 && drained[0] == "aaa"s && v.IsEmpty());
+        v.PushBack("again"s);
+        assert(v.GetSize() == 1 && v[0] == "again"s);
+    }
+    {
+        // Drain выделяет итоговый блок один раз и перемещает каждый элемент один раз
+        using Item = Instrumented<>;
+        operation_counts = {};
+        ConcurrentVector<Item, CountingAllocator<Item>> v;
+        for (int i = 0; i < 100; ++i) {
+            v.EmplaceBack(i);
+        }
+        // Сегменты по 32, 64 и 128 элементов
+        ExpectOperations({.value_constructions = 100, .moves = 100, .destructions = 100, .allocations = 3});
+        SimpleVector<Item, CountingAllocator<Item>> drained = v.Drain();
+        ExpectOperations({.moves = 100, .destructions = 100, .allocations = 1, .deallocations = 3});
+        assert(drained.GetSize() == 100 && drained.GetCapacity() == 100 && drained[99].GetValue() == 99);
+    }
+    cout << "Done!"s << endl << endl;
+}
+
+void TestSoaSimpleVector() {
+    cout << "Test structure of arrays vector"s << endl;
+    {
+        SoaSimpleVector<int, double, string> v;
+        for (int i = 0; i < 100; ++i) {
+            v.PushBack(i, i * 0.5, to_string(i));
+        }
+        assert(v.GetSize() == 100 && v.GetCapacity() >= 100);
+        // Столбцы непрерывны и выровнены
+        const span<const int> ids = as_const(v).GetColumn<0>();
+        assert(accumulate(ids.begin(), ids.end(), 0) == 4950);
+        assert((reinterpret_cast<uintptr_t>(v.GetColumn<1>().data()) % SoaSimpleVector<int, double, string>::kColumnAlignment == 0));
+        assert(v.Get<2>(42) == "42"s);
+
+        auto [id, weight, name] = v[7];
+        weight = 100.0;
+        assert(v.Get<1>(7) == 100.0 && id == 7 && name == "7"s);
+
+        auto it = v.Insert(v.begin() + 1, -1, -1.0, "inserted"s);
+        assert(it.GetIndex() == 1 && get<2>(*it) == "inserted"s && v.Get<0>(2) == 1 && v.GetSize() == 101);
+        const string name0 = v.Get<2>(0);
+        v.Insert(v.begin(), v.Get<0>(0), v.Get<1>(0), v.Get<2>(0));
+        assert(v.Get<2>(0) == name0 && v.Get<2>(1) == name0);
+
+        it = v.Erase(v.begin(), v.begin() + 3);
+        assert(get<0>(*it) == 1 && v.GetSize() == 99);
+        v.Erase(v.begin() + 10);
+        assert(v.Get<2>(10) == "12"s);
+
+        v.Resize(200);
+        assert(v.Get<0>(199) == 0 && v.Get<2>(199).empty() && v.Get<2>(97) == "99"s);
+        v.Resize(50);
+        v.PopBack();
+        assert(v.GetSize() == 49);
+
+        size_t rows = 0;
+        for (auto [row_id, row_weight, row_name] : v) {
+            assert(row_name.empty() || row_name == to_string(row_id));
+            ++rows;
+        }
+        assert(rows == 49 && v.end() - v.begin() == 49);
+
+        SoaSimpleVector<int, double, string> copy(v);
+        assert(copy == v);
+        copy.Get<2>(3) = "changed"s;
+        assert(copy != v);
+        SoaSimpleVector<int, double, string> moved(move(copy));
+        assert(copy.IsEmpty() && moved.GetSize() == 49);
+        moved.ShrinkToFit();
+        assert(moved.GetCapacity() == 49 && moved.Get<2>(3) == "changed"s);
+    }
+    {
+        SoaSimpleVector<uint8_t, unique_ptr<int>> v;
+        v.EmplaceBack(1, make_unique<int>(10));
+        v.PushBack(2, make_unique<int>(20));
+        assert(*v.Get<1>(1) == 20 && v.Get<0>(0) == 1);
+        v.Erase(v.begin());
+        assert(v.GetSize() == 1 && *v.Get<1>(0) == 20);
+    }
+    cout << "Done!"s << endl << endl;
+}
+
+void TestCowSimpleVector() {
+    cout << "Test copy-on-write vector"s << endl;
+    {
+        CowSimpleVector<string> original{"a"s, "b"s, "c"s};
+        const string* data = original.GetVector().begin();
+        CowSimpleVector<string> copy(original);
+        assert(copy.IsShared() && original.IsShared() && copy == original);
+        // Чтение через константный доступ не клонирует буфер
+        assert(as_const(copy)[1] == "b"s && as_const(copy).begin() == data);
+
+        copy.PushBack("d"s);
+        assert(!copy.IsShared() && !original.IsShared());
+        assert(original.GetSize() == 3 && copy.GetSize() == 4 && original.GetVector().begin() == data);
+
+        CowSimpleVector<string> second = original;
+        auto it = second.Insert(second.cbegin() + 1, "x"s);
+        assert(*it == "x"s && second.GetSize() == 4 && original[1] == "b"s);
+        second = original;
+        second.Erase(second.cbegin(), second.cbegin() + 2);
+        assert(second.GetSize() == 1 && second[0] == "c"s && original.GetSize() == 3);
+        second = original;
+        second[0] = "changed"s;
+        assert(original[0] == "a"s && original < second);
+        second = original;
+        second.Resize(1);
+        assert(original.GetSize() == 3 && second.GetSize() == 1);
+
+        second = original;
+        second.Clear();
+        assert(second.IsEmpty() && original.GetSize() == 3 && !original.IsShared());
+        CowSimpleVector<string> moved(move(original));
+        assert(original.IsEmpty() && moved.GetVector().begin() == data);
+    }
+    {
+        CowSimpleVector<int> empty;
+        assert(empty.IsEmpty() && empty.begin() == empty.end());
+        empty.EmplaceBack(1);
+        assert(empty.GetSize() == 1);
+
+        CowSimpleVector<int> shared(SimpleVector<int>(100'000, 1));
+        vector<thread> readers;
+        atomic<size_t> total = 0;
+        for (size_t t = 0; t < 4; ++t) {
+            readers.emplace_back([snapshot = shared, t, &total]() mutable {
+                if (t == 0) {
+                    snapshot[0] = 2;
+                }
+                total += accumulate(snapshot.cbegin(), snapshot.cend(), size_t{0});
+            });
+        }
+        shared.PushBack(5);
+        for (thread& reader : readers) {
+            reader.join();
+        }
+        assert(total == 4 * 100'000 + 1 && shared.GetSize() == 100'001 && !shared.IsShared());
+    }
+    {
+        // Ссылка и итератор, выданные до копирования, не меняют копию: такой буфер копируется сразу
+        CowSimpleVector<int> v{1, 2, 3};
+        int& first = v[0];
+        auto it = v.begin();
+        CowSimpleVector<int> copy(v);
+        assert(!copy.IsShared() && !v.IsShared());
+        first = 10;
+        it[1] = 20;
+        assert(as_const(copy)[0] == 1 && as_const(copy)[1] == 2 && as_const(v)[1] == 20);
+        CowSimpleVector<int> assigned;
+        assigned = v;
+        first = 11;
+        assert(as_const(assigned)[0] == 10 && as_const(v)[0] == 11);
+
+        // Буфер, на который изменяемых ссылок не выдавали, по-прежнему разделяется
+        CowSimpleVector<int> fresh{1, 2};
+        CowSimpleVector<int> shared(fresh);
+        assert(shared.IsShared() && as_const(shared).begin() == as_const(fresh).begin());
+
+        // После переезда в новый блок или Clear старые ссылки недействительны, и копирование снова O(1)
+        CowSimpleVector<int> walked{1, 2, 3};
+        for (int& value : walked) {
+            ++value;
+        }
+        assert(!CowSimpleVector<int>(walked).IsShared());
+        walked.Reserve(100);
+        CowSimpleVector<int> after_growth(walked);
+        assert(after_growth.IsShared() && as_const(after_growth).begin() == as_const(walked).begin());
+        after_growth = CowSimpleVector<int>();
+        walked[0] = 5;
+        // realloc может ужать блок на месте: тогда ссылки действительны и буфер по-прежнему не разделяется
+        const int* before_shrink = as_const(walked).begin();
+        walked.ShrinkToFit();
+        const bool shrink_moved = as_const(walked).begin() != before_shrink;
+        assert(CowSimpleVector<int>(walked).IsShared() == shrink_moved && as_const(walked)[0] == 5);
+        walked.At(1) = 6;
+        walked.Clear();
+        assert(CowSimpleVector<int>(walked).IsShared());
+    }
+    {
+        // Новый буфер после Clear разделяемой копии и после перемещения берётся у ресурса этой копии
+        using Alloc = pmr::polymorphic_allocator<int>;
+        MonotonicArena arena;
+        const Alloc alloc(&arena);
+        CowSimpleVector<int, Alloc> v({1, 2, 3}, alloc);
+        CowSimpleVector<int, Alloc> copy(v);
+        v.Clear();
+        v.PushBack(4);
+        assert(v.GetVector().GetAllocator().resource() == &arena && copy.GetSize() == 3);
+        CowSimpleVector<int, Alloc> moved(move(v));
+        v.PushBack(5);
+        assert(v.GetVector().GetAllocator().resource() == &arena && moved[0] == 4);
+
+        // Клон разделяемого буфера тоже остаётся в ресурсе копии
+        CowSimpleVector<int, Alloc> other(alloc);
+        other = moved;
+        other.PushBack(6);
+        assert(other.GetVector().GetAllocator().resource() == &arena && moved.GetSize() == 1);
+    }
+    cout << "Done!"s << endl << endl;
+}
+
+void TestFlatSetAndMap() {
+    cout << "Test flat set and map"s << endl;
+    {
+        // Поиск без ветвлений совпадает с std::lower_bound на всех позициях
+        const int keys[] = {1, 3, 3, 5, 7, 9, 11};
+        for (int key = 0; key <= 12; ++key) {
+            const size_t expected = lower_bound(begin(keys), end(keys), key) - begin(keys);
+            assert(BranchlessLowerBound(keys, size(keys), key, less<int>{}) == expected);
+        }
+        assert(BranchlessLowerBound(keys, 0, 5, less<int>{}) == 0);
+    }
+    {
+        FlatSet<int> set{5, 1, 3, 5, 1, 9};
+        assert(set.GetSize() == 4 && *set.begin() == 1);
+        assert(set.Contains(3) && !set.Contains(4) && set.Count(9) == 1);
+        assert(set.Insert(4).second && !set.Insert(4).second && set.GetSize() == 5);
+        assert(*set.LowerBound(6) == 9 && *set.UpperBound(4) == 5 && set.LowerBound(10) == set.end());
+        assert(set.Erase(3) == 1 && set.Erase(3) == 0 && set.Find(3) == set.end());
+        set.InsertBatch({7, 0, 5, 7, 2});
+        assert((set.GetVector() == SimpleVector<int>{0, 1, 2, 4, 5, 7, 9}));
+        set.Erase(set.Find(0));
+        assert(*set.begin() == 1);
+    }
+    for (SearchLayout layout : {SearchLayout::kSorted, SearchLayout::kEytzinger}) {
+        // Сравнение с std::set на псевдослучайных данных при каждом расположении ключей
+        FlatSet<int> set;
+        set.SetLayout(layout);
+        std::set<int> expected;
+        for (int round = 0; round < 5; ++round) {
+            vector<int> batch;
+            for (int i = 0; i < 200; ++i) {
+                batch.push_back((round * 7919 + i * 104729) % 1009);
+            }
+            set.InsertBatch(batch);
+            expected.insert(batch.begin(), batch.end());
+            set.Insert(round * 1000);
+            expected.insert(round * 1000);
+            set.Erase(batch[round]);
+            expected.erase(batch[round]);
+            assert(set.GetSize() == expected.size() && equal(set.begin(), set.end(), expected.begin()));
+        }
+        assert(set.GetLayout() == layout);
+        for (int key = -1; key <= 4001; ++key) {
+            const auto it = set.LowerBound(key);
+            const auto expected_it = expected.lower_bound(key);
+            assert((it == set.end()) == (expected_it == expected.end()));
+            assert(it == set.end() || *it == *expected_it);
+            assert(set.Contains(key) == (expected.count(key) == 1));
+        }
+    }
+    {
+        // Пачка копируется в рабочий вектор одним выделением и дописывается к элементам ещё одним;
+        // stable_sort и inplace_merge берут временную память не у аллокатора множества
+        using Item = Instrumented<>;
+        FlatSet<Item, less<Item>, CountingAllocator<Item>> set;
+        for (int round = 0; round < 2; ++round) {
+            vector<Item> batch;
+            for (int i = 0; i < 100; ++i) {
+                batch.emplace_back((i * 37) % 100 * 2 + round);
+            }
+            operation_counts = {};
+            set.InsertBatch(move(batch));
+            assert(operation_counts.allocations == 2 && operation_counts.deallocations == 1 + round);
+        }
+        assert(set.GetSize() == 200 && set.begin()->GetValue() == 0 && prev(set.end())->GetValue() == 199);
+    }
+    {
+        // Из пар с одинаковым ключом остаётся первая
+        FlatMap<int, string> map{{3, "c"s}, {1, "a"s}, {3, "x"s}, {2, "b"s}};
+        assert(map.GetSize() == 3 && map.At(3) == "c"s);
+        assert((map.GetKeys() == SimpleVector<int>{1, 2, 3}));
+        auto [key, value] = *map.begin();
+        assert(key == 1 && value == "a"s);
+        value = "A"s;
+        assert(map.At(1) == "A"s);
+
+        map[0] = "zero"s;
+        assert(map.GetSize() == 4 && (*map.begin()).second == "zero"s && map[5].empty() && map.GetSize() == 5);
+        assert(!map.Insert(2, "y"s).second && map.At(2) == "b"s);
+        try {
+            map.At(42);
+            assert(false);
+        }
+        catch (const out_of_range&) {
+        }
+
+        // Существующие ключи пачка не заменяет
+        map.InsertBatch(vector<pair<int, string>>{{4, "d"s}, {2, "skip"s}, {6, "f"s}, {4, "dup"s}});
+        assert((map.GetKeys() == SimpleVector<int>{0, 1, 2, 3, 4, 5, 6}));
+        assert((map.GetValues() == SimpleVector<string>{"zero"s, "A"s, "b"s, "c"s, "d"s, ""s, "f"s}));
+
+        map.SetLayout(SearchLayout::kEytzinger);
+        assert(map.Find(4).GetValue() == "d"s && map.Find(7) == map.end());
+        assert(map.Erase(4) == 1 && !map.Contains(4) && map.GetSize() == 6);
+        auto it = map.Erase(map.Find(0));
+        assert(it.GetKey() == 1 && (*map.LowerBound(4)).first == 5 && map.UpperBound(6) == map.end());
+        size_t count = 0;
+        for (auto [k, v] : as_const(map)) {
+            assert(map.At(k) == v);
+            ++count;
+        }
+        assert(count == map.GetSize());
+    }
+    {
+        std::map<int, int> expected;
+        FlatMap<int, int> map;
+        map.SetLayout(SearchLayout::kEytzinger);
+        for (int round = 0; round < 4; ++round) {
+            vector<pair<int, int>> batch;
+            for (int i = 0; i < 300; ++i) {
+                batch.emplace_back((round * 31 + i * 7727) % 2003, round);
+            }
+            map.InsertBatch(batch);
+            expected.insert(batch.begin(), batch.end());
+        }
+        assert(map.GetSize() == expected.size());
+        for (const auto& [key, value] : expected) {
+            assert(map.At(key) == value);
+        }
+        FlatMap<int, int> copy(SortedUniqueTag{}, map.GetKeys(), map.GetValues());
+        assert(copy == map);
+    }
+    cout << "Done!"s << endl << endl;
+}
+
+void TestPackedBoolVector() {
+    cout << "Test packed bool vector"s << endl;
+    {
+        SimpleVector<bool> flags{true, false, true};
+        assert(flags.GetSize() == 3 && flags.GetCapacity() == 64 && flags.GetWords().size() == 1);
+        assert(flags[0] && !flags[1] && flags.At(2));
+        flags[1] = true;
+        flags[0] = flags[1] = false;
+        assert(!flags[0] && !flags[1] && flags.Count() == 1 && flags.FindFirst() == 2);
+        flags[2].Flip();
+        assert(flags.Count() == 0 && flags.FindFirst() == flags.GetSize());
+        try {
+            flags.At(3);
+            assert(false);
+        }
+        catch (const out_of_range&) {
+        }
+
+        SimpleVector<bool> ones(130, true);
+        assert(ones.Count() == 130 && ones.GetWords().size() == 3 && ones.GetWords()[2] == 3);
+        ones.Resize(65);
+        assert(ones.Count() == 65 && ones.GetWords()[1] == 1);
+        ones.Resize(200);
+        assert(ones.Count() == 65 && ones.FindNext(65) == 200);
+        ones.PopBack();
+        assert(ones.GetSize() == 199 && (~ones).Count() == 134);
+    }
+    {
+        // Сравнение с std::vector<bool> при вставках и удалениях, пересекающих границы слов
+        SimpleVector<bool> packed;
+        vector<bool> expected;
+        for (size_t i = 0; i < 300; ++i) {
+            const bool value = (i * 7 + i / 5) % 3 == 0;
+            packed.PushBack(value);
+            expected.push_back(value);
+        }
+        for (size_t round = 0; round < 40; ++round) {
+            const size_t index = (round * 37) % (packed.GetSize() + 1);
+            const size_t count = round % 5 == 0 ? 70 : round % 3;
+            const bool value = round % 2 == 0;
+            packed.Insert(packed.cbegin() + index, count, value);
+            expected.insert(expected.begin() + index, count, value);
+            const size_t erase_from = (round * 53) % packed.GetSize();
+            const size_t erase_count = min<size_t>(round % 4 == 0 ? 90 : 1, packed.GetSize() - erase_from);
+            packed.Erase(packed.cbegin() + erase_from, packed.cbegin() + erase_from + erase_count);
+            expected.erase(expected.begin() + erase_from, expected.begin() + erase_from + erase_count);
+            assert(packed.GetSize() == expected.size() && equal(packed.cbegin(), packed.cend(), expected.begin()));
+            assert(packed.Count() == static_cast<size_t>(count_if(expected.begin(), expected.end(), [](bool b) { return b; })));
+        }
+        const vector<bool> tail{true, false, true, true};
+        packed.Append(tail);
+        expected.insert(expected.end(), tail.begin(), tail.end());
+        packed.Insert(packed.cbegin() + 1, {false, true});
+        expected.insert(expected.begin() + 1, {false, true});
+        assert(equal(packed.cbegin(), packed.cend(), expected.begin(), expected.end()));
+
+        size_t found = 0;
+        for (size_t i = packed.FindFirst(); i < packed.GetSize(); i = packed.FindNext(i + 1)) {
+            assert(expected[i]);
+            ++found;
+        }
+        assert(found == packed.Count());
+    }
+    {
+        SimpleVector<bool> lhs(100);
+        SimpleVector<bool> rhs(100);
+        for (size_t i = 0; i < 100; ++i) {
+            lhs[i] = i % 2 == 0;
+            rhs[i] = i % 3 == 0;
+        }
+        assert((lhs & rhs).Count() == 17 && (lhs | rhs).Count() == 67 && (lhs ^ rhs).Count() == 50);
+        SimpleVector<bool> mask = lhs;
+        mask &= rhs;
+        assert(mask == (lhs & rhs) && mask != lhs);
+        try {
+            mask |= SimpleVector<bool>(99);
+            assert(false);
+        }
+        catch (const invalid_argument&) {
+        }
+
+        // Лексикографический порядок совпадает с порядком std::vector<bool>
+        const vector<vector<bool>> samples{{}, {false}, {true}, {false, true}, vector<bool>(64, true),
+            vector<bool>(65, true), vector<bool>(70, false), vector<bool>(130, false)};
+        for (const auto& a : samples) {
+            for (const auto& b : samples) {
+                SimpleVector<bool> pa;
+                pa.Append(a);
+                SimpleVector<bool> pb;
+                pb.Append(b);
+                assert((pa < pb) == (a < b) && (pa == pb) == (a == b) && (pa >= pb) == (a >= b));
+            }
+        }
+        SimpleVector<bool> big(200);
+        SimpleVector<bool> other(200);
+        other[150] = true;
+        assert(big < other && !(other < big));
+        big[149] = true;
+        assert(other < big);
+    }
+    cout << "Done!"s << endl << endl;
+}
+
+bool IsAligned(const void* ptr, size_t alignment) {
+    return reinterpret_cast<uintptr_t>(ptr) % alignment == 0;
+}
+
+struct alignas(128) WideItem {
+    int value = 0;
+};
+
+void TestAlignedStorage() {
+    cout << "Test aligned storage"s << endl;
+    {
+        SimpleVector<float, Align<64>> values;
+        for (int i = 0; i < 1000; ++i) {
+            values.PushBack(static_cast<float>(i));
+            assert(IsAligned(values.begin(), 64));
+        }
+        values.Insert(values.cbegin() + 3, 500, 1.0f);
+        values.ShrinkToFit();
+        assert(IsAligned(values.begin(), 64) && values[1499] == 999.0f);
+        values.Reserve(5000);
+        assert(IsAligned(values.begin(), 64));
+        const SimpleVector<float, Align<64>> copy(values);
+        assert(IsAligned(copy.begin(), 64) && copy == values);
+
+        // Хвост до границы блока выделен: векторный цикл может читать и писать целые регистры
+        SimpleVector<float, Align<64>> small(5, 2.0f);
+        const size_t padded = AlignedAllocator<float, 64>::PaddedSize(small.GetSize());
+        assert(padded == 16);
+        float* data = small.begin();
+        for (size_t i = small.GetSize(); i < padded; ++i) {
+            data[i] = 0.0f;
+        }
+        assert(accumulate(data, data + padded, 0.0f) == 10.0f);
+    }
+    {
+        // Выравнивание 16 байт с хвостом до 64 байт
+        SimpleVector<double, Align<16, 64>> values(3, 1.0);
+        assert(IsAligned(values.begin(), 16) && (AlignedAllocator<double, 16, 64>::PaddedSize(3) == 8));
+        values.begin()[7] = 0.0;
+
+        SimpleVector<string, Align<64>> strings;
+        for (int i = 0; i < 100; ++i) {
+            strings.Insert(strings.cbegin(), to_string(i));
+            assert(IsAligned(strings.begin(), 64));
+        }
+        assert(strings[0] == "99"s && strings[99] == "0"s);
+
+        SimpleVector<bool, Align<64>> flags(1000, true);
+        flags.PushBack(false);
+        assert(IsAligned(flags.GetWords().data(), 64) && flags.Count() == 1000);
+    }
+    {
+        // Типы с повышенным выравниванием выравниваются и без Align
+        SimpleVector<WideItem> items;
+        for (int i = 0; i < 50; ++i) {
+            items.PushBack(WideItem{i});
+            assert(IsAligned(items.begin(), alignof(WideItem)));
+        }
+        items.Insert(items.cbegin() + 10, WideItem{-1});
+        assert(IsAligned(items.begin(), 128) && items[10].value == -1 && items[50].value == 49);
+        SimpleVector<WideItem, Align<32>> wide(7);
+        assert(IsAligned(wide.begin(), 128) && (AlignedAllocator<WideItem, 32>::kAlignment == 128));
+    }
+    cout << "Done!"s << endl << endl;
+}
+
+void TestAdoptAndSlice() {
+    cout << "Test adopt, release and slice"s << endl;
+    {
+        // Буфер из "сетевой библиотеки" переходит в вектор без копирования
+        int freed = 0;
+        int* buffer = static_cast<int*>(malloc(8 * sizeof(int)));
+        iota(buffer, buffer + 5, 0);
+        {
+            auto values = SimpleVector<int>::Adopt(buffer, 5, 8, [&freed](int* ptr) {
+                free(ptr);
+                ++freed;
+            });
+            assert(values.begin() == buffer && values.GetSize() == 5 && values.GetCapacity() == 8 && values[4] == 4);
+            values.PushBack(5);
+            assert(values.begin() == buffer && freed == 0);
+            // Рост переносит элементы в память аллокатора и освобождает чужой буфер
+            values.Insert(values.cend(), {6, 7, 8});
+            assert(freed == 1 && values.GetSize() == 9 && values[8] == 8 && values[5] == 5);
+        }
+        assert(freed == 1);
+    }
+    {
+        size_t freed_capacity = 0;
+        auto* raw = static_cast<string*>(malloc(4 * sizeof(string)));
+        new (raw) string("first"s);
+        new (raw + 1) string("second"s);
+        {
+            auto strings = SimpleVector<string>::Adopt(raw, 2, 4, [&freed_capacity](string* ptr, size_t capacity) {
+                free(ptr);
+                freed_capacity = capacity;
+            });
+            strings.PushBack("third"s);
+            assert(strings.begin() == raw && strings[2] == "third"s);
+        }
+        // Элементы разрушил вектор, память вернул deleter
+        assert(freed_capacity == 4);
+    }
+    {
+        // Release отдаёт буфер, Adopt забирает его обратно
+        SimpleVector<int> values{1, 2, 3};
+        values.Reserve(10);
+        const int* data = values.begin();
+        ReleasedBuffer<int> released = values.Release();
+        assert(values.IsEmpty() && values.GetCapacity() == 0 && released.data == data);
+        assert(released.size == 3 && released.capacity == 10);
+        values.PushBack(42);
+        auto restored = SimpleVector<int>::Adopt(released.data, released.size, released.capacity, values.GetAllocator());
+        assert((restored == SimpleVector<int>{1, 2, 3}) && restored.begin() == data);
+
+        // У буфера с deleter Release его не вызывает
+        bool deleted = false;
+        int* external = new int[2]{7, 8};
+        auto adopted = SimpleVector<int>::Adopt(external, 2, 2, [&deleted](int* ptr) {
+            deleted = true;
+            delete[] ptr;
+        });
+        ReleasedBuffer<int> back = adopted.Release();
+        assert(!deleted && back.data == external && back.data[1] == 8);
+        delete[] back.data;
+    }
+    {
+        // Вместимость хранит ArrayPtr, deleter размером с указатель — он же, без блока в куче
+        static_assert(sizeof(SimpleVector<int>) == 5 * sizeof(void*));
+        // Deleter крупнее указателя лежит в куче и переезжает вместе с буфером
+        string log;
+        const string tag = "external buffer"s;
+        int* external = new int[3]{1, 2, 3};
+        {
+            auto adopted = SimpleVector<int>::Adopt(external, 3, 3, [&log, tag](int* ptr) {
+                log = tag;
+                delete[] ptr;
+            });
+            SimpleVector<int> moved(std::move(adopted));
+            assert(moved.GetCapacity() == 3 && moved[2] == 3 && adopted.GetCapacity() == 0);
+            assert(log.empty());
+        }
+        assert(log == tag);
+    }
+    {
+        SimpleVector<int> values{0, 1, 2, 3, 4, 5};
+        span<int> middle = values.Slice(1, 4);
+        assert(middle.size() == 3 && middle.data() == values.begin() + 1);
+        middle[0] = 10;
+        assert(values[1] == 10);
+        span<const int> tail = as_const(values).Slice(4, 6);
+        assert(tail.size() == 2 && tail[1] == 5 && values.Slice(6, 6).empty());
+        try {
+            values.Slice(2, 7);
+            assert(false);
+        }
+        catch (const out_of_range&) {
+        }
+        try {
+            values.Slice(3, 2);
+            assert(false);
+        }
+        catch (const out_of_range&) {
+        }
+    }
+    cout << "Done!"s << endl << endl;
+}
+
+template <typename Type, typename MakeValue>
+void CheckDevectorAgainstDeque(MakeValue make_value) {
+    SimpleDevector<Type> devector;
+    deque<Type> expected;
+    for (size_t step = 0; step < 2000; ++step) {
+        const Type value = make_value(step);
+        switch (step * 7 % 9) {
+        case 0:
+        case 1:
+            devector.PushFront(value);
+            expected.push_front(value);
+            break;
+        case 2:
+        case 3:
+            devector.PushBack(value);
+            expected.push_back(value);
+            break;
+        case 4: {
+            const size_t index = step % (expected.size() + 1);
+            assert(*devector.Insert(devector.cbegin() + index, value) == value);
+            expected.insert(expected.begin() + index, value);
+            break;
+        }
+        case 5:
+            if (!expected.empty()) {
+                const size_t index = step % expected.size();
+                devector.Erase(devector.cbegin() + index);
+                expected.erase(expected.begin() + index);
+            }
+            break;
+        case 6:
+            if (!expected.empty()) {
+                devector.PopFront();
+                expected.pop_front();
+            }
+            break;
+        case 7:
+            if (!expected.empty()) {
+                devector.PopBack();
+                expected.pop_back();
+            }
+            break;
+        default: {
+            const size_t from = step % (expected.size() + 1);
+            const size_t count = min<size_t>(3, expected.size() - from);
+            devector.Erase(devector.cbegin() + from, devector.cbegin() + from + count);
+            expected.erase(expected.begin() + from, expected.begin() + from + count);
+        }
+        }
+        assert(devector.GetSize() == expected.size() && equal(devector.begin(), devector.end(), expected.begin()));
+        assert(devector.GetFrontSpace() + devector.GetSize() + devector.GetBackSpace() == devector.GetCapacity());
+    }
+}
+
+void TestSimpleDevector() {
+    cout << "Test simple devector"s << endl;
+    {
+        SimpleDevector<int> values{2, 3};
+        values.PushFront(1);
+        values.EmplaceFront(0);
+        values.PushBack(4);
+        assert((values == SimpleDevector<int>{0, 1, 2, 3, 4}) && values.At(4) == 4);
+        values.PopFront();
+        assert(values[0] == 1 && values.GetFrontSpace() >= 1);
+        values.ShrinkToFit();
+        assert(values.GetCapacity() == 4 && values.GetFrontSpace() == 0);
+        values.ReserveFront(10);
+        assert(values.GetFrontSpace() >= 10 && values[3] == 4);
+        const int* data = values.begin();
+        for (int i = 0; i < 10; ++i) {
+            values.PushFront(-i);
+        }
+        assert(values.begin() == data - 10 && values.GetSize() == 14 && values[0] == -9);
+        values.Resize(20);
+        assert(values[19] == 0 && values[13] == 4);
+        SimpleDevector<int> copy = values;
+        assert(copy == values && !(copy < values));
+        copy.PushFront(-100);
+        assert(copy < values && values != copy);
+    }
+    {
+        // Вставка в начало: переносов элементов O(log n), а не сдвиг всего буфера на каждом шаге
+        SimpleDevector<int> values;
+        size_t relocations = 0;
+        for (int i = 0; i < 100000; ++i) {
+            const int* data = values.begin();
+            values.PushFront(i);
+            if (values.begin() + 1 != data) {
+                ++relocations;
+            }
+        }
+        assert(values[0] == 99999 && values[99999] == 0 && relocations < 40);
+
+        // Скользящее окно не растит буфер без ограничений
+        SimpleDevector<int> window;
+        for (int i = 0; i < 100000; ++i) {
+            window.PushBack(i);
+            if (window.GetSize() > 100) {
+                window.PopFront();
+            }
+        }
+        assert(window.GetSize() == 100 && window[0] == 99900 && window.GetCapacity() <= 512);
+    }
+    CheckDevectorAgainstDeque<int>([](size_t step) {
+        return static_cast<int>(step);
+    });
+    CheckDevectorAgainstDeque<string>([](size_t step) {
+        return "value "s + to_string(step);
+    });
+    cout << "Done!"s << endl << endl;
+}
+
+void TestRingBuffer() {
+    cout << "Test ring buffer"s << endl;
+    {
+        RingBuffer<int> reject(3);
+        assert(reject.PushBack(1) && reject.PushBack(2) && reject.PushBack(3));
+        assert(!reject.PushBack(4) && reject.IsFull() && reject.Front() == 1 && reject.Back() == 3);
+        int value = 0;
+        assert(reject.TryPop(value) && value == 1 && reject.PushBack(4));
+        assert(reject[0] == 2 && reject[2] == 4 && reject.At(1) == 3);
+
+        RingBuffer<int> overwrite(3, OverflowPolicy::kOverwrite);
+        for (int i = 0; i < 5; ++i) {
+            assert(overwrite.PushBack(i));
+        }
+        assert(overwrite.GetSize() == 3 && overwrite[0] == 2 && overwrite[2] == 4);
+        try {
+            RingBuffer<int> empty(0);
+            assert(false);
+        }
+        catch (const invalid_argument&) {
+        }
+    }
+    {
+        // Пачки проходят через границу памяти буфера двумя непрерывными частями
+        RingBuffer<string> buffer(5);
+        const vector<string> first{"a"s, "b"s, "c"s, "d"s};
+        assert(buffer.PushBatch(first) == 4);
+        buffer.Consume(3);
+        const vector<string> second{"e"s, "f"s, "g"s, "h"s, "i"s};
+        assert(buffer.PushBatch(second) == 4 && buffer.IsFull());
+        RingSpans<string> spans = buffer.PeekBatch();
+        assert(spans.first.size() == 2 && spans.second.size() == 3);
+        assert(spans.first[0] == "d"s && spans.first[1] == "e"s && spans.second[2] == "h"s);
+        vector<string> out(3);
+        assert(buffer.PopBatch(out) == 3 && (out == vector<string>{"d"s, "e"s, "f"s}));
+        assert(buffer.GetSize() == 2 && buffer.Front() == "g"s);
+
+        RingBuffer<string> window(3, OverflowPolicy::kOverwrite);
+        window.PushBack("x"s);
+        assert(window.PushBatch(second) == 5 && window.GetSize() == 3);
+        assert(window[0] == "g"s && window[2] == "i"s);
+        assert(window.PushBatch(span<const string>(second).first(2)) == 2);
+        assert(window[0] == "i"s && window[1] == "e"s && window[2] == "f"s);
+        RingBuffer<string> moved(std::move(window));
+        assert(moved.GetSize() == 3 && window.IsEmpty());
+        // Перемещённый буфер без памяти отвергает элементы вместо перезаписи
+        assert(moved.GetPolicy() == OverflowPolicy::kOverwrite && window.GetPolicy() == OverflowPolicy::kReject);
+        assert(!window.PushBack("y"s) && window.PushBatch(second) == 0 && window.IsEmpty());
+        RingBuffer<string> assigned(1);
+        assigned = std::move(moved);
+        assert(assigned.GetPolicy() == OverflowPolicy::kOverwrite && !moved.PushBack("z"s));
+        assert(assigned.PushBack("z"s) && assigned[2] == "z"s);
+    }
+    {
+        SpscRingBuffer<int> queue(5);
+        assert(queue.GetCapacity() == 8);
+        const vector<int> items{1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+        assert(queue.PushBatch(items) == 8 && !queue.TryPush(9));
+        int value = 0;
+        assert(queue.TryPop(value) && value == 1 && queue.TryPush(9));
+        RingSpans<int> spans = queue.PeekBatch();
+        assert(spans.first.size() == 7 && spans.second.size() == 1 && spans.second[0] == 9);
+        queue.Consume(8);
+        assert(queue.IsEmpty() && !queue.TryPop(value));
+    }
+    {
+        // Производитель и потребитель в разных потоках: порядок и содержимое сохраняются
+        const int count = 200000;
+        SpscRingBuffer<string> queue(64);
+        thread producer([&queue, count] {
+            vector<string> batch;
+            int next = 0;
+            while (next < count) {
+                if (next % 3 == 0) {
+                    batch.clear();
+                    for (int i = next; i < min(count, next + 7); ++i) {
+                        batch.push_back(to_string(i));
+                    }
+                    next += static_cast<int>(queue.PushBatch(batch));
+                }
+                else if (queue.TryPush(to_string(next))) {
+                    ++next;
+                }
+            }
+        });
+        int expected = 0;
+        bool ordered = true;
+        vector<string> out(5);
+        while (expected < count) {
+            const size_t popped = queue.PopBatch(out);
+            for (size_t i = 0; i < popped; ++i) {
+                ordered = ordered && out[i] == to_string(expected++);
+            }
+        }
+        producer.join();
+        assert(ordered && queue.IsEmpty());
+    }
+    cout << "Done!"s << endl << endl;
+}
+
+void TestBufferCache() {
+    cout << "Test buffer cache"s << endl;
+    using CachedVector = SimpleVector<int, CachingAllocator<int>>;
+    {
+        // Вектор того же размера после прогрева получает освобождённый блок из кэша потока
+        const BufferCacheStats before = BufferCache::GetThreadStats();
+        const int* data = nullptr;
+        {
+            CachedVector v(100, 1);
+            data = v.begin();
+        }
+        CachedVector v(100, 2);
+        const BufferCacheStats after = BufferCache::GetThreadStats();
+        assert(v.begin() == data && after.thread_hits == before.thread_hits + 1);
+
+        // Рост в пределах класса не меняет блок: 100 и 120 элементов int помещаются в 512 байт
+        v.Reserve(120);
+        assert(v.begin() == data && v[99] == 2);
+        assert(BufferCache::GetBlockSize(100 * sizeof(int)) == 512);
+    }
+    {
+        // Кэш потока ограничен, лишние блоки уходят в общий пул и достаются другому потоку
+        const size_t count = BufferCache::kThreadBlocksPerClass * 3;
+        vector<void*> blocks;
+        for (size_t i = 0; i < count; ++i) {
+            blocks.push_back(BufferCache::Allocate(3000));
+        }
+        for (void* ptr : blocks) {
+            BufferCache::Deallocate(ptr, 3000);
+        }
+        BufferCacheStats worker_stats;
+        bool reused = true;
+        thread worker([&] {
+            for (size_t i = 0; i < BufferCache::kThreadBlocksPerClass; ++i) {
+                void* ptr = BufferCache::Allocate(4000);
+                reused = reused && find(blocks.begin(), blocks.end(), ptr) != blocks.end();
+                BufferCache::Deallocate(ptr, 4000);
+            }
+            worker_stats = BufferCache::GetThreadStats();
+        });
+        worker.join();
+        assert(reused && worker_stats.global_hits == 1 && worker_stats.thread_hits == BufferCache::kThreadBlocksPerClass - 1);
+        assert(worker_stats.misses == 0 && worker_stats.GetHitRate() == 1.0);
+
+        const BufferCacheStats before = BufferCache::GetThreadStats();
+        void* big = BufferCache::Allocate(BufferCache::kMaxCachedBytes + 1);
+        BufferCache::Deallocate(big, BufferCache::kMaxCachedBytes + 1);
+        assert(BufferCache::GetThreadStats().bypassed == before.bypassed + 1);
+        assert(BufferCache::GetStats().global_hits >= 1);
+        BufferCache::ReleaseThreadCache();
+        BufferCache::Trim();
+    }
+    {
+        // Векторы строк в нескольких потоках
+        vector<thread> workers;
+        atomic<bool> ok = true;
+        for (int t = 0; t < 4; ++t) {
+            workers.emplace_back([&ok, t] {
+                for (int round = 0; round < 200; ++round) {
+                    SimpleVector<string, CachingAllocator<string>> v;
+                    for (int i = 0; i < 50; ++i) {
+                        v.PushBack(to_string(t * i + round));
+                    }
+                    if (v[49] != to_string(t * 49 + round)) {
+                        ok = false;
+                    }
+                }
+            });
+        }
+        for (thread& worker : workers) {
+            worker.join();
+        }
+        assert(ok && BufferCache::GetStats().GetHitRate() > 0.5);
+    }
+    cout << "Done!"s << endl << endl;
+}
+
+// Сортирует копию values функциями Sort и StableSort и сверяет с std::stable_sort
+template <typename Type, typename Compare = less<>>
+void CheckSortAgainstStd(const vector<Type>& values, Compare comp = Compare()) {
+    vector<Type> expected = values;
+    stable_sort(expected.begin(), expected.end(), comp);
+    SimpleVector<Type> sorted(values.size());
+    copy(values.begin(), values.end(), sorted.begin());
+    Sort(sorted, comp);
+    assert(equal(sorted.begin(), sorted.end(), expected.begin(), expected.end(), [&comp](const Type& lhs, const Type& rhs) {
+        return !comp(lhs, rhs) && !comp(rhs, lhs);
+    }));
+    copy(values.begin(), values.end(), sorted.begin());
+    StableSort(sorted, comp);
+    assert(equal(sorted.begin(), sorted.end(), expected.begin(), expected.end()));
+}
+
+void TestSort() {
+    cout << "Test sort"s << endl;
+    mt19937_64 random(42);
+    {
+        SimpleVector<int> small{3, -1, 2};
+        Sort(small);
+        assert((small == SimpleVector<int>{-1, 2, 3}));
+        Sort(small, greater<>());
+        assert((small == SimpleVector<int>{3, 2, -1}));
+    }
+    auto check_all = [&random] {
+        for (size_t size : {size_t{0}, size_t{1}, size_t{100}, size_t{5000}, size_t{200000}}) {
+            vector<uint64_t> unsigned_values(size);
+            vector<int32_t> signed_values(size);
+            vector<int16_t> narrow_values(size);
+            vector<double> doubles(size);
+            vector<float> floats(size);
+            for (size_t i = 0; i < size; ++i) {
+                unsigned_values[i] = random() >> (i % 3 == 0 ? 40 : 0);
+                signed_values[i] = static_cast<int32_t>(random());
+                narrow_values[i] = static_cast<int16_t>(random() % 100 - 50);
+                doubles[i] = static_cast<double>(static_cast<int64_t>(random() % 2000001) - 1000000) / 7.0;
+                floats[i] = static_cast<float>(doubles[i]);
+            }
+            if (size > 10) {
+                doubles[3] = numeric_limits<double>::infinity();
+                doubles[7] = -numeric_limits<double>::infinity();
+            }
+            CheckSortAgainstStd(unsigned_values);
+            CheckSortAgainstStd(unsigned_values, greater<uint64_t>());
+            CheckSortAgainstStd(signed_values);
+            CheckSortAgainstStd(narrow_values, ranges::greater());
+            CheckSortAgainstStd(doubles);
+            CheckSortAgainstStd(floats, greater<>());
+
+            // Общий путь: строки и устойчивость на парах с повторяющимися ключами
+            vector<string> strings(size);
+            vector<pair<int, int>> pairs(size);
+            for (size_t i = 0; i < size; ++i) {
+                strings[i] = to_string(random() % 1000);
+                pairs[i] = {static_cast<int>(random() % 50), static_cast<int>(i)};
+            }
+            CheckSortAgainstStd(strings);
+            CheckSortAgainstStd(pairs, [](const pair<int, int>& lhs, const pair<int, int>& rhs) {
+                return lhs.first < rhs.first;
+            });
+        }
+    };
+    check_all();
+    ParallelExecution::Enable(3, 1024);
+    check_all();
+    {
+        // Исключение из сравнения в потоке пула доходит до вызывающего кода
+        SimpleVector<int> values(1000000);
+        iota(values.begin(), values.end(), 0);
+        bool thrown = false;
+        try {
+            Sort(values, [](int lhs, int rhs) {
+                if (lhs == 777777 || rhs == 777777) {
+                    throw runtime_error("compare");
+                }
+                return lhs > rhs;
+            });
+        }
+        catch (const runtime_error&) {
+            thrown = true;
+        }
+        assert(thrown);
+    }
+    ParallelExecution::Disable();
+    {
+        SimpleDevector<double> devector{2.5, -1.0, 0.0};
+        devector.PushFront(10.0);
+        StableSort(devector);
+        assert((devector == SimpleDevector<double>{-1.0, 0.0, 2.5, 10.0}));
+        vector<int> plain{5, 4, 3};
+        Sort(span<int>(plain).first(2));
+        assert((plain == vector<int>{4, 5, 3}));
+    }
+    {
+        // -0.0 и 0.0 эквивалентны: устойчивая сортировка сохраняет их исходный порядок
+        SimpleVector<double> values;
+        vector<bool> zero_signs;
+        for (size_t i = 0; i < 4 * kRadixSortMinSize; ++i) {
+            if (i % 3 == 0) {
+                values.PushBack(static_cast<double>(random() % 50 + 1) * (random() % 2 == 0 ? 1.0 : -1.0));
+            }
+            else {
+                const bool negative = random() % 2 == 0;
+                values.PushBack(negative ? -0.0 : 0.0);
+                zero_signs.push_back(negative);
+            }
+        }
+        for (bool descending : {false, true}) {
+            SimpleVector<double> sorted = values;
+            if (descending) {
+                StableSort(sorted, greater<>());
+            }
+            else {
+                StableSort(sorted);
+            }
+            vector<bool> sorted_signs;
+            for (double value : sorted) {
+                if (value == 0.0) {
+                    sorted_signs.push_back(signbit(value));
+                }
+            }
+            assert(sorted_signs == zero_signs);
+        }
+    }
+    cout << "Done!"s << endl << endl;
+}
+
+// Сжимает values, проверяет доступ по индексу, обход и распаковку на всех уровнях SIMD
+template <typename Type>
+void CheckCompressedVector(const vector<Type>& values) {
+    const CompressedVector<Type> compressed(span<const Type>(values.data(), values.size()));
+    assert(compressed.GetSize() == values.size());
+    for (SimdLevel level : {SimdLevel::kScalar, SimdLevel::kSse2, SimdLevel::kAvx2}) {
+        SimdCompare::SetLevel(level);
+        assert(equal(compressed.begin(), compressed.end(), values.begin(), values.end()));
+        const SimpleVector<Type> expanded = compressed.Decompress();
+        assert(equal(expanded.begin(), expanded.end(), values.begin(), values.end()));
+    }
+    for (size_t i = 0; i < values.size(); i += 7) {
+        assert(compressed[i] == values[i]);
+    }
+    if (!values.empty()) {
+        assert(compressed.At(values.size() - 1) == values.back());
+    }
+
+    // Дописывание по одному значению и пачками даёт тот же вектор
+    CompressedVector<Type> appended;
+    const size_t half = values.size() / 2;
+    for (size_t i = 0; i < half; ++i) {
+        appended.PushBack(values[i]);
+    }
+    appended.Append(span<const Type>(values.data() + half, values.size() - half));
+    assert(appended == compressed);
+}
+
+void TestCompressedVector() {
+    cout << "Test compressed vector"s << endl;
+    mt19937_64 random(7);
+    {
+        CompressedVector<uint32_t> small{5, 3, 9};
+        assert(small.GetSize() == 3 && small[1] == 3 && small.GetBlockCount() == 0);
+        try {
+            small.At(3);
+            assert(false);
+        }
+        catch (const out_of_range&) {
+        }
+        CheckCompressedVector(vector<uint32_t>{});
+        CheckCompressedVector(vector<uint32_t>(1000, 42));
+    }
+    {
+        // Отсортированные идентификаторы с небольшими разрывами сжимаются больше чем вчетверо
+        vector<uint32_t> ids(100000);
+        uint32_t id = 1000000;
+        for (uint32_t& value : ids) {
+            id += 1 + static_cast<uint32_t>(random() % 60);
+            value = id;
+        }
+        CheckCompressedVector(ids);
+        const CompressedVector<uint32_t> compressed(span<const uint32_t>(ids.data(), ids.size()));
+        assert(compressed.GetMemoryUsage() * 4 < ids.size() * sizeof(uint32_t));
+
+        vector<uint64_t> wide(ids.begin(), ids.end());
+        for (uint64_t& value : wide) {
+            value += uint64_t{1} << 40;
+        }
+        CheckCompressedVector(wide);
+        const CompressedVector<uint64_t> compressed_wide(span<const uint64_t>(wide.data(), wide.size()));
+        assert(compressed_wide.GetMemoryUsage() * 6 < wide.size() * sizeof(uint64_t));
+    }
+    {
+        // Несортированные данные, крайние значения и полная ширина блока
+        vector<uint32_t> noisy(5000);
+        vector<uint64_t> extreme(1000);
+        for (size_t i = 0; i < noisy.size(); ++i) {
+            noisy[i] = static_cast<uint32_t>(1000 + i * 3 + random() % 50);
+        }
+        for (size_t i = 0; i < extreme.size(); ++i) {
+            extreme[i] = i % 2 == 0 ? numeric_limits<uint64_t>::max() - i : i;
+        }
+        extreme[500] = random();
+        CheckCompressedVector(noisy);
+        CheckCompressedVector(extreme);
+        vector<uint32_t> random_values(3000);
+        for (uint32_t& value : random_values) {
+            value = static_cast<uint32_t>(random());
+        }
+        CheckCompressedVector(random_values);
+    }
+    SimdCompare::SetLevel(SimdLevel::kAvx2);
+    cout << "Done!"s << endl << endl;
+}
+
+void TestOperationCosts() {
+    cout << "Test operation costs"s << endl;
+    using Item = Instrumented<>;
+    using Vector = CostVector<Item>;
+    operation_counts = {};
+    {
+        Vector empty;
+        ExpectOperations({});
+        Vector sized(3);
+        ExpectOperations({.default_constructions = 3, .allocations = 1});
+        const Item value(7);
+        Vector filled(3, value);
+        ExpectOperations({.value_constructions = 1, .copies = 3, .allocations = 1});
+        Vector listed{Item(1), Item(2)};
+        ExpectOperations({.value_constructions = 2, .copies = 2, .destructions = 2, .allocations = 1});
+        Vector reserved(Reserve(4));
+        ExpectOperations({.allocations = 1});
+    }
+    ExpectOperations({.destructions = 9, .deallocations = 4});
+    {
+        Vector v(Reserve(8));
+        const Item value(1);
+        ExpectOperations({.value_constructions = 1, .allocations = 1});
+
+        // Добавление в конец при свободном месте: ровно одно конструирование, без перевыделений
+        v.PushBack(value);
+        ExpectOperations({.copies = 1});
+        v.PushBack(Item(2));
+        ExpectOperations({.value_constructions = 1, .moves = 1, .destructions = 1});
+        v.EmplaceBack(3);
+        ExpectOperations({.value_constructions = 1});
+        v.EmplaceBack(4);
+        ExpectOperations({.value_constructions = 1});
+
+        // Вставка в середину: временная копия, один элемент уезжает за конец, остальные сдвигаются присваиванием
+        v.Insert(v.begin() + 1, value);
+        ExpectOperations({.copies = 1, .moves = 1, .move_assignments = 3, .destructions = 1});
+        v.Insert(v.end(), value);
+        ExpectOperations({.copies = 1});
+        v.Emplace(v.begin(), 0);
+        ExpectOperations({.value_constructions = 1, .moves = 1, .move_assignments = 6, .destructions = 1});
+        assert(v.GetSize() == 7 && v.GetCapacity() == 8);
+
+        // Удаление: хвост сдвигается присваиванием, разрушается ровно удалённое число элементов
+        v.Erase(v.begin() + 1);
+        ExpectOperations({.move_assignments = 5, .destructions = 1});
+        v.Erase(v.begin(), v.begin() + 2);
+        ExpectOperations({.move_assignments = 4, .destructions = 2});
+        v.PopBack();
+        ExpectOperations({.destructions = 1});
+        assert(v.GetSize() == 3 && v[0].GetValue() == 2);
+
+        // Пачка из двух элементов в середину: одно перемещение в сырую память, сдвиг и присваивание копий
+        const SimpleVector<Item> batch{Item(8), Item(9)};
+        ExpectOperations({.value_constructions = 2, .copies = 2, .destructions = 2});
+        v.Insert(v.begin(), batch.begin(), batch.end());
+        ExpectOperations({.copy_assignments = 2, .moves = 2, .move_assignments = 1});
+        v.Insert(v.begin() + 4, size_t{2}, value);
+        ExpectOperations({.copies = 2, .copy_assignments = 1, .moves = 1, .destructions = 1});
+        assert(v.GetSize() == 7 && v.GetCapacity() == 8);
+
+        v.Resize(5);
+        ExpectOperations({.destructions = 2});
+        v.Resize(8);
+        ExpectOperations({.default_constructions = 3});
+        v.Reserve(8);
+        ExpectOperations({});
+        v.Clear();
+        ExpectOperations({.destructions = 8});
+        assert(v.GetCapacity() == 8);
+    }
+    ExpectOperations({.destructions = 3, .deallocations = 1});
+    {
+        Vector lhs{Item(1), Item(2), Item(3)};
+        Vector rhs{Item(4), Item(5)};
+        ExpectOperations({.value_constructions = 5, .copies = 5, .destructions = 5, .allocations = 2});
+
+        // Копирование: одно выделение и по копии на элемент
+        Vector copy(lhs);
+        ExpectOperations({.copies = 3, .allocations = 1});
+        // Присваивание копированием через copy-and-swap: одно выделение, прежние элементы разрушаются вместе с их блоком
+        copy = rhs;
+        ExpectOperations({.copies = 2, .destructions = 3, .allocations = 1, .deallocations = 1});
+
+        // Перемещение и обмен не трогают элементы
+        Vector moved(std::move(lhs));
+        ExpectOperations({});
+        moved.swap(rhs);
+        ExpectOperations({});
+        moved = std::move(rhs);
+        ExpectOperations({.destructions = 2, .deallocations = 1});
+        // Сравнение и доступ к элементам без копий
+        assert(moved != copy && moved < copy && moved.At(0).GetValue() == 1);
+        ExpectOperations({});
+    }
+    ExpectOperations({.destructions = 5, .deallocations = 2});
+    {
+        // Перемещение между неравными аллокаторами: одно выделение у получателя и по перемещению на элемент,
+        // память источника остаётся у него
+        using ArenaVector = SimpleVector<Item, ArenaCountingAllocator<Item>>;
+        ArenaVector lhs({Item(1), Item(2)}, ArenaCountingAllocator<Item>(1));
+        ArenaVector rhs({Item(3), Item(4), Item(5)}, ArenaCountingAllocator<Item>(2));
+        ExpectOperations({.value_constructions = 5, .copies = 5, .destructions = 5, .allocations = 2});
+        lhs = std::move(rhs);
+        ExpectOperations({.moves = 3, .destructions = 3 + 2, .allocations = 1, .deallocations = 1});
+        assert(lhs.GetAllocator().GetArena() == 1 && lhs.GetSize() == 3 && lhs[2].GetValue() == 5);
+        assert(rhs.IsEmpty() && rhs.GetCapacity() == 3);
+
+        // Аллокаторы равны: блок переходит целиком
+        ArenaVector same({Item(6)}, ArenaCountingAllocator<Item>(1));
+        ExpectOperations({.value_constructions = 1, .copies = 1, .destructions = 1, .allocations = 1});
+        lhs = std::move(same);
+        ExpectOperations({.destructions = 3, .deallocations = 1});
+    }
+    ExpectOperations({.destructions = 1, .deallocations = 2});
+    {
+        // ResizeForOverwrite конструирует по умолчанию только новые элементы, рост — одно перевыделение
+        Vector v{Item(1), Item(2)};
+        ExpectOperations({.value_constructions = 2, .copies = 2, .destructions = 2, .allocations = 1});
+        v.ResizeForOverwrite(5);
+        ExpectOperations({.default_constructions = 3, .moves = 2, .destructions = 2, .allocations = 1, .deallocations = 1});
+        v.ResizeForOverwrite(1);
+        ExpectOperations({.destructions = 4});
+        v.ResizeForOverwrite(4);
+        ExpectOperations({.default_constructions = 3});
+        assert(v.GetSize() == 4 && v.GetCapacity() == 5 && v[0].GetValue() == 1);
+
+        // Release и Adopt передают буфер без операций над элементами и памятью
+        ReleasedBuffer<Item> released = v.Release();
+        Vector restored = Vector::Adopt(released.data, released.size, released.capacity);
+        ExpectOperations({});
+        assert(restored.GetSize() == 4 && restored.GetCapacity() == 5 && restored[0].GetValue() == 1);
+    }
+    ExpectOperations({.destructions = 4, .deallocations = 1});
+    {
+        // Чужой буфер освобождает deleter, а не аллокатор; при росте элементы переезжают по одному разу
+        auto* raw = static_cast<Item*>(malloc(2 * sizeof(Item)));
+        new (raw) Item(1);
+        new (raw + 1) Item(2);
+        int freed = 0;
+        ExpectOperations({.value_constructions = 2});
+        {
+            Vector adopted = Vector::Adopt(raw, 2, 2, [&freed](Item* ptr) {
+                free(ptr);
+                ++freed;
+            });
+            ExpectOperations({});
+            adopted.PushBack(Item(3));
+            ExpectOperations({.value_constructions = 1, .moves = 1 + 2, .destructions = 1 + 2, .allocations = 1});
+            assert(freed == 1 && adopted.GetSize() == 3 && adopted[2].GetValue() == 3);
+        }
+        ExpectOperations({.destructions = 3, .deallocations = 1});
+    }
+    cout << "Done!"s << endl << endl;
+}
+
+// Стоимость роста вектора Item от пустого до count элементов вызовами PushBack(Item&&)
+template <typename Item>
+void CheckPushBackGrowth(int count, const OperationCounts& expected) {
+    operation_counts = {};
+    {
+        CostVector<Item> v;
+        for (int i = 0; i < count; ++i) {
+            v.PushBack(Item(i));
+        }
+        assert(v.GetSize() == static_cast<size_t>(count) && v[count - 1].GetValue() == count - 1);
+        ExpectOperations(expected);
+    }
+    ExpectOperations({.destructions = count, .deallocations = 1});
+}
+
+void TestGrowthCosts() {
+    cout << "Test growth costs"s << endl;
+    // 100 элементов: вместимости 1, 2, 4, ..., 128 — 8 выделений, при росте переносятся 1 + 2 + ... + 64 = 127 элементов
+    CheckPushBackGrowth<Instrumented<>>(100,
+        {.value_constructions = 100, .moves = 100 + 127, .destructions = 100 + 127, .allocations = 8, .deallocations = 7});
+    // Перемещение может выбросить исключение: при росте элементы копируются ради строгой гарантии
+    CheckPushBackGrowth<Instrumented<false>>(100,
+        {.value_constructions = 100, .copies = 127, .moves = 100, .destructions = 100 + 127, .allocations = 8, .deallocations = 7});
+    // Тривиально перемещаемые элементы переезжают побайтно; новый элемент перемещается ещё раз,
+    // потому что создаётся до перевыделения
+    CheckPushBackGrowth<Instrumented<true, true>>(100,
+        {.value_constructions = 100, .moves = 100 + 8, .destructions = 100 + 8, .allocations = 8, .deallocations = 7});
+
+    using Item = Instrumented<>;
+    operation_counts = {};
+    {
+        CostVector<Item> v{Item(1), Item(2)};
+        ExpectOperations({.value_constructions = 2, .copies = 2, .destructions = 2, .allocations = 1});
+
+        // Вставка в заполненный вектор: новый элемент конструируется сразу в новом блоке, остальные переносятся один раз
+        const Item value(0);
+        v.Insert(v.begin() + 1, value);
+        ExpectOperations({.value_constructions = 1, .copies = 1, .moves = 2, .destructions = 2, .allocations = 1, .deallocations = 1});
+        v.EmplaceBack(3);
+        ExpectOperations({.value_constructions = 1});
+        v.EmplaceBack(4);
+        ExpectOperations({.value_constructions = 1, .moves = 4, .destructions = 4, .allocations = 1, .deallocations = 1});
+
+        // Диапазон, не помещающийся в вектор: одно перевыделение на всю пачку
+        const SimpleVector<Item> batch(6, value);
+        ExpectOperations({.copies = 6});
+        v.Append(batch);
+        ExpectOperations({.copies = 6, .moves = 5, .destructions = 5, .allocations = 1, .deallocations = 1});
+        assert(v.GetSize() == 11 && v.GetCapacity() == 16);
+
+        v.Reserve(20);
+        ExpectOperations({.moves = 11, .destructions = 11, .allocations = 1, .deallocations = 1});
+        v.Resize(25);
+        ExpectOperations({.default_constructions = 14, .moves = 11, .destructions = 11, .allocations = 1, .deallocations = 1});
+        assert(v.GetCapacity() == 40);
+        v.ShrinkToFit();
+        ExpectOperations({.moves = 25, .destructions = 25, .allocations = 1, .deallocations = 1});
+        v.ShrinkToFit();
+        ExpectOperations({});
+    }
+    ExpectOperations({.destructions = 25 + 1 + 6, .deallocations = 1});
+    {
+        // Временный диапазон и перемещающие итераторы: одно перевыделение и по одному перемещению на элемент
+        CostVector<Item> v{Item(1), Item(2)};
+        SimpleVector<Item> rvalue_batch(100);
+        SimpleVector<Item> moved_batch(50);
+        ExpectOperations({.default_constructions = 150, .value_constructions = 2, .copies = 2, .destructions = 2, .allocations = 1});
+        v.Append(std::move(rvalue_batch));
+        ExpectOperations({.moves = 100 + 2, .destructions = 2, .allocations = 1, .deallocations = 1});
+        assert(v.GetSize() == 102 && v.GetCapacity() == 102);
+        v.Insert(v.begin() + 1, make_move_iterator(moved_batch.begin()), make_move_iterator(moved_batch.end()));
+        ExpectOperations({.moves = 50 + 102, .destructions = 102, .allocations = 1, .deallocations = 1});
+        assert(v.GetSize() == 152 && v.GetCapacity() == 204);
+        assert(v[0].GetValue() == 1 && v[1].GetValue() == 0 && v[51].GetValue() == 2);
+    }
+    ExpectOperations({.destructions = 152 + 150, .deallocations = 1});
+
+    // Тривиально перемещаемые элементы: сдвиги при вставке и удалении побайтные
+    using Relocatable = Instrumented<true, true>;
+    {
+        CostVector<Relocatable> v(Reserve(4));
+        v.EmplaceBack(1);
+        v.EmplaceBack(2);
+        v.EmplaceBack(3);
+        ExpectOperations({.value_constructions = 3, .allocations = 1});
+        v.Emplace(v.begin(), 0);
+        ExpectOperations({.value_constructions = 1, .moves = 1, .destructions = 1});
+        v.Erase(v.begin());
+        ExpectOperations({.destructions = 1});
+        v.Erase(v.begin(), v.begin() + 2);
+        ExpectOperations({.destructions = 2});
+        v.Reserve(100);
+        ExpectOperations({.allocations = 1, .deallocations = 1});
+        assert(v.GetSize() == 1 && v[0].GetValue() == 3);
+    }
+    ExpectOperations({.destructions = 1, .deallocations = 1});
+    cout << "Done!"s << endl << endl;
+}
+
 int main() {
     TestTemporaryObjConstructor();
     TestTemporaryObjOperator();
@@ -159,5 +2487,35 @@ int main() {
     TestNoncopiablePushBack();
     TestNoncopiableInsert();
     TestNoncopiableErase();
+    TestReserveConstructsNothing();
+    TestEmplace();
+    TestResizeDestroysTail();
+    TestTriviallyRelocatable();
+    TestPmrAllocator();
+    TestSizeClassPool();
+    TestSmallSimpleVector();
+    TestGrowthPolicies();
+    TestShrinkToFit();
+    TestVectorStats();
+    TestRangeInsert();
+    TestAppendAndRangeErase();
+    TestParallelBulkOperations();
+    TestSimdCompare();
+    TestMmapAllocator();
+    TestBinarySerialization();
+    TestConcurrentVector();
+    TestSoaSimpleVector();
+    TestCowSimpleVector();
+    TestFlatSetAndMap();
+    TestPackedBoolVector();
+    TestAlignedStorage();
+    TestAdoptAndSlice();
+    TestSimpleDevector();
+    TestRingBuffer();
+    TestBufferCache();
+    TestSort();
+    TestCompressedVector();
+    TestOperationCosts();
+    TestGrowthCosts();
     return 0;
 }
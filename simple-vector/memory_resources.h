@@ -0,0 +1,224 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+
+// Монотонная арена: раздаёт память сдвигом указателя внутри крупных блоков
+// и ничего не освобождает поштучно. Вся память возвращается разом через Release()
+// или в деструкторе. Не потокобезопасна: рассчитана на одну арену на запрос или поток
+class MonotonicArena : public std::pmr::memory_resource {
+public:
+    explicit MonotonicArena(size_t initial_block_size = 4096,
+        std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+        : upstream_(upstream)
+        , next_block_size_(std::max(initial_block_size, sizeof(Block) * 2)) {
+    }
+
+    // Начинает раздачу с внешнего буфера; блоки из upstream берутся, только когда буфер исчерпан
+    MonotonicArena(void* buffer, size_t buffer_size,
+        std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+        : MonotonicArena(buffer_size * 2, upstream) {
+        current_ = static_cast<std::byte*>(buffer);
+        end_ = current_ + buffer_size;
+        initial_buffer_ = current_;
+        initial_end_ = end_;
+    }
+
+    MonotonicArena(const MonotonicArena&) = delete;
+    MonotonicArena& operator=(const MonotonicArena&) = delete;
+
+    ~MonotonicArena() override {
+        Release();
+    }
+
+    // Возвращает в upstream все блоки арены; выданные ранее указатели становятся недействительными
+    void Release() noexcept {
+        while (blocks_ != nullptr) {
+            Block* next = blocks_->next;
+            upstream_->deallocate(blocks_, blocks_->size, alignof(std::max_align_t));
+            blocks_ = next;
+        }
+        current_ = initial_buffer_;
+        end_ = initial_end_;
+        bytes_allocated_ = 0;
+    }
+
+    // Возвращает суммарный объём памяти, выданной с момента создания или последнего Release()
+    size_t GetBytesAllocated() const noexcept {
+        return bytes_allocated_;
+    }
+
+private:
+    struct Block {
+        Block* next;
+        size_t size;
+    };
+
+    std::pmr::memory_resource* upstream_;
+    size_t next_block_size_;
+    Block* blocks_ = nullptr;
+    std::byte* current_ = nullptr;
+    std::byte* end_ = nullptr;
+    std::byte* initial_buffer_ = nullptr;
+    std::byte* initial_end_ = nullptr;
+    size_t bytes_allocated_ = 0;
+
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        void* ptr = TryBump(bytes, alignment);
+        if (ptr == nullptr) {
+            AddBlock(bytes + alignment);
+            ptr = TryBump(bytes, alignment);
+            assert(ptr != nullptr);
+        }
+        bytes_allocated_ += bytes;
+        return ptr;
+    }
+
+    void do_deallocate(void*, size_t, size_t) override {
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+    void* TryBump(size_t bytes, size_t alignment) noexcept {
+        if (current_ == nullptr) {
+            return nullptr;
+        }
+        const auto address = reinterpret_cast<std::uintptr_t>(current_);
+        const size_t padding = (alignment - address % alignment) % alignment;
+        if (static_cast<size_t>(end_ - current_) < padding + bytes) {
+            return nullptr;
+        }
+        std::byte* ptr = current_ + padding;
+        current_ = ptr + bytes;
+        return ptr;
+    }
+
+    void AddBlock(size_t min_bytes) {
+        const size_t size = std::max(next_block_size_, min_bytes + sizeof(Block));
+        auto* block = static_cast<Block*>(upstream_->allocate(size, alignof(std::max_align_t)));
+        block->next = blocks_;
+        block->size = size;
+        blocks_ = block;
+        current_ = reinterpret_cast<std::byte*>(block + 1);
+        end_ = reinterpret_cast<std::byte*>(block) + size;
+        next_block_size_ = size * 2;
+    }
+};
+
+// Пул блоков фиксированных размеров: запросы до kMaxPooledSize байт округляются
+// до степени двойки и обслуживаются из списков свободных блоков своего класса.
+// Освобождённый блок возвращается в список и сразу переиспользуется.
+// Крупные запросы и запросы с повышенным выравниванием уходят в upstream.
+// Не потокобезопасен: рассчитан на один пул на поток
+class SizeClassPool : public std::pmr::memory_resource {
+public:
+    static constexpr size_t kMinPooledSize = 16;
+    static constexpr size_t kMaxPooledSize = 4096;
+
+    explicit SizeClassPool(std::pmr::memory_resource* upstream = std::pmr::new_delete_resource(),
+        size_t chunk_size = 64 * 1024)
+        : upstream_(upstream)
+        , chunk_size_(std::max(chunk_size, kMaxPooledSize + sizeof(Chunk))) {
+    }
+
+    SizeClassPool(const SizeClassPool&) = delete;
+    SizeClassPool& operator=(const SizeClassPool&) = delete;
+
+    ~SizeClassPool() override {
+        Release();
+    }
+
+    // Возвращает в upstream все куски, из которых нарезаны блоки классов.
+    // Крупные блоки, выданные напрямую из upstream, освобождаются через deallocate
+    void Release() noexcept {
+        while (chunks_ != nullptr) {
+            Chunk* next = chunks_->next;
+            upstream_->deallocate(chunks_, chunk_size_, alignof(std::max_align_t));
+            chunks_ = next;
+        }
+        free_lists_.fill(nullptr);
+    }
+
+private:
+    static constexpr size_t kClassCount = 9;  // 16, 32, ..., 4096
+
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    struct alignas(std::max_align_t) Chunk {
+        Chunk* next;
+    };
+
+    std::pmr::memory_resource* upstream_;
+    size_t chunk_size_;
+    Chunk* chunks_ = nullptr;
+    std::array<FreeBlock*, kClassCount> free_lists_{};
+
+    static bool IsPooled(size_t bytes, size_t alignment) noexcept {
+        return bytes <= kMaxPooledSize && alignment <= alignof(std::max_align_t);
+    }
+
+    static size_t ClassIndex(size_t bytes) noexcept {
+        size_t index = 0;
+        size_t class_size = kMinPooledSize;
+        while (class_size < bytes) {
+            class_size *= 2;
+            ++index;
+        }
+        return index;
+    }
+
+    static size_t ClassSize(size_t index) noexcept {
+        return kMinPooledSize << index;
+    }
+
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        if (!IsPooled(bytes, alignment)) {
+            return upstream_->allocate(bytes, alignment);
+        }
+        const size_t index = ClassIndex(bytes);
+        if (free_lists_[index] == nullptr) {
+            Refill(index);
+        }
+        FreeBlock* block = free_lists_[index];
+        free_lists_[index] = block->next;
+        return block;
+    }
+
+    void do_deallocate(void* ptr, size_t bytes, size_t alignment) override {
+        if (!IsPooled(bytes, alignment)) {
+            upstream_->deallocate(ptr, bytes, alignment);
+            return;
+        }
+        const size_t index = ClassIndex(bytes);
+        auto* block = static_cast<FreeBlock*>(ptr);
+        block->next = free_lists_[index];
+        free_lists_[index] = block;
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+    // Нарезает новый кусок из upstream на блоки класса index
+    void Refill(size_t index) {
+        auto* chunk = static_cast<Chunk*>(upstream_->allocate(chunk_size_, alignof(std::max_align_t)));
+        chunk->next = chunks_;
+        chunks_ = chunk;
+        const size_t class_size = ClassSize(index);
+        std::byte* begin = reinterpret_cast<std::byte*>(chunk + 1);
+        const size_t count = (chunk_size_ - sizeof(Chunk)) / class_size;
+        for (size_t i = count; i > 0; --i) {
+            auto* block = reinterpret_cast<FreeBlock*>(begin + (i - 1) * class_size);
+            block->next = free_lists_[index];
+            free_lists_[index] = block;
+        }
+    }
+};
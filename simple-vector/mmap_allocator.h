@@ -0,0 +1,183 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <new>
+#include <type_traits>
+
+#if __has_include(<sys/mman.h>) && __has_include(<unistd.h>)
+#include <sys/mman.h>
+#include <unistd.h>
+#else
+#error "mmap_allocator.h requires POSIX mmap"
+#endif
+
+#include "growth_policy.h"
+#include "simple_vector.h"
+
+// Аллокатор для очень больших векторов: каждый блок — отдельное отображение mmap.
+// reallocate переносит страницы через mremap, не копируя данные, поэтому рост
+// вектора тривиально перемещаемых элементов не требует ни копии, ни второго блока памяти.
+// С HugePages = true блоки выравниваются по 2 МиБ и помечаются madvise(MADV_HUGEPAGE),
+// чтобы ядро отобразило их прозрачными большими страницами.
+// Каждый блок занимает целое число страниц, поэтому аллокатор не подходит для мелких векторов.
+// Размер страницы (4, 16 или 64 КиБ) узнаётся у системы во время выполнения. Только для POSIX-систем
+template <typename Type, bool HugePages = false>
+class MmapAllocator {
+public:
+    using value_type = Type;
+    using is_always_equal = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    template <typename Other>
+    struct rebind {
+        using other = MmapAllocator<Other, HugePages>;
+    };
+
+    // Размер большой страницы x86-64, по которому выравниваются блоки при HugePages
+    static constexpr size_t kHugePageSize = size_t{2} << 20;
+
+    // Страница не бывает меньше 4 КиБ, поэтому такого выравнивания отображения хватает
+    static_assert(alignof(Type) <= 4096, "mmap aligns blocks only to the page size");
+
+    MmapAllocator() noexcept = default;
+
+    template <typename Other>
+    MmapAllocator(const MmapAllocator<Other, HugePages>&) noexcept {
+    }
+
+    // Отображает память под size элементов
+    [[nodiscard]] Type* allocate(size_t size) {
+        const size_t bytes = MappedBytes(size);
+        void* ptr = HugePages ? MapAligned(bytes) : Map(bytes);
+        Advise(ptr, bytes);
+        return static_cast<Type*>(ptr);
+    }
+
+    void deallocate(Type* ptr, size_t size) noexcept {
+        if (ptr != nullptr) {
+            munmap(static_cast<void*>(ptr), MappedBytes(size));
+        }
+    }
+
+    // Изменяет размер отображения с old_size до new_size элементов.
+    // Страницы остаются на месте, если за блоком есть свободные адреса, иначе ядро переносит их целиком
+    [[nodiscard]] Type* reallocate(Type* ptr, size_t old_size, size_t new_size) {
+        if (ptr == nullptr) {
+            return allocate(new_size);
+        }
+        const size_t old_bytes = MappedBytes(old_size);
+        const size_t new_bytes = MappedBytes(new_size);
+        if (old_bytes == new_bytes) {
+            return ptr;
+        }
+        void* old_ptr = static_cast<void*>(ptr);
+#if defined(__linux__)
+        void* new_ptr = mremap(old_ptr, old_bytes, new_bytes, 0);
+        if (new_ptr == MAP_FAILED) {
+            if constexpr (HugePages) {
+                // Переносим страницы в заранее зарезервированный выровненный диапазон
+                void* target = MapAligned(new_bytes);
+                new_ptr = mremap(old_ptr, old_bytes, new_bytes, MREMAP_MAYMOVE | MREMAP_FIXED, target);
+                if (new_ptr == MAP_FAILED) {
+                    munmap(target, new_bytes);
+                }
+            }
+            else {
+                new_ptr = mremap(old_ptr, old_bytes, new_bytes, MREMAP_MAYMOVE);
+            }
+        }
+        if (new_ptr == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+        if (new_bytes > old_bytes) {
+            Advise(new_ptr, new_bytes);
+        }
+        return static_cast<Type*>(new_ptr);
+#else
+        Type* new_ptr = allocate(new_size);
+        std::memcpy(static_cast<void*>(new_ptr), old_ptr, std::min(old_size, new_size) * sizeof(Type));
+        deallocate(ptr, old_size);
+        return new_ptr;
+#endif
+    }
+
+    // Гранулярность блоков: страница или большая страница
+    static size_t GetGranularity() noexcept {
+        static const size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        return HugePages ? std::max(page_size, kHugePageSize) : page_size;
+    }
+
+private:
+    static size_t MappedBytes(size_t size) {
+        const size_t granularity = GetGranularity();
+        if (size > (std::numeric_limits<size_t>::max() - 2 * granularity) / sizeof(Type)) {
+            throw std::bad_array_new_length();
+        }
+        return std::max<size_t>((size * sizeof(Type) + granularity - 1) / granularity, 1) * granularity;
+    }
+
+    static void* Map(size_t bytes) {
+        void* ptr = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (ptr == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+        return ptr;
+    }
+
+    // Отображает bytes байт по адресу, кратному kHugePageSize: берёт диапазон с запасом и обрезает края
+    static void* MapAligned(size_t bytes) {
+        auto* reserved = static_cast<char*>(Map(bytes + kHugePageSize));
+        const auto address = reinterpret_cast<uintptr_t>(reserved);
+        const size_t head = (kHugePageSize - address % kHugePageSize) % kHugePageSize;
+        if (head != 0) {
+            munmap(reserved, head);
+        }
+        munmap(reserved + head + bytes, kHugePageSize - head);
+        return reserved + head;
+    }
+
+    static void Advise([[maybe_unused]] void* ptr, [[maybe_unused]] size_t bytes) noexcept {
+#ifdef MADV_HUGEPAGE
+        if constexpr (HugePages) {
+            // Подсказка необязательна: без поддержки THP память остаётся на обычных страницах
+            madvise(ptr, bytes, MADV_HUGEPAGE);
+        }
+#endif
+    }
+};
+
+template <typename Type, typename Other, bool HugePages>
+bool operator==(const MmapAllocator<Type, HugePages>&, const MmapAllocator<Other, HugePages>&) noexcept {
+    return true;
+}
+
+template <typename Type, typename Other, bool HugePages>
+bool operator!=(const MmapAllocator<Type, HugePages>&, const MmapAllocator<Other, HugePages>&) noexcept {
+    return false;
+}
+
+// Удваивает вместимость и округляет её вверх до целого числа страниц текущей системы
+// (или больших страниц при HugePages): так вектор пользуется всей памятью отображения
+template <bool HugePages = false>
+struct MmapGrowth {
+    static size_t NextCapacity(size_t capacity, size_t required, size_t element_size) noexcept {
+        const size_t target = DoublingGrowth::NextCapacity(capacity, required, element_size);
+        const size_t granularity = MmapAllocator<std::byte, HugePages>::GetGranularity();
+        if (target > (std::numeric_limits<size_t>::max() - granularity) / element_size) {
+            // Слишком большой запрос отклонит сам аллокатор
+            return target;
+        }
+        const size_t bytes = (target * element_size + granularity - 1) / granularity * granularity;
+        return std::max(target, bytes / element_size);
+    }
+};
+
+// Вектор на отображениях mmap. Вместимость округляется до целых страниц,
+// чтобы вектор пользовался всей памятью, которую всё равно занимает отображение
+template <typename Type, bool HugePages = false>
+using MmapSimpleVector = SimpleVector<Type, MmapAllocator<Type, HugePages>, MmapGrowth<HugePages>>;
@@ -0,0 +1,322 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <latch>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "simd_compare.h"
+
+// Параллельное выполнение массовых операций вектора: заполнения, копирования и сравнения.
+// По умолчанию выключено; ParallelExecution::Enable запускает пул потоков,
+// и операции над блоками от заданного размера делятся между потоками пула
+
+// Пул потоков с общей очередью задач
+class ThreadPool {
+public:
+    explicit ThreadPool(size_t thread_count) {
+        workers_.reserve(thread_count);
+        for (size_t i = 0; i < thread_count; ++i) {
+            workers_.emplace_back([this] {
+                Work();
+            });
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    ~ThreadPool() {
+        {
+            std::lock_guard guard(mutex_);
+            stopped_ = true;
+        }
+        has_tasks_.notify_all();
+        for (std::thread& worker : workers_) {
+            worker.join();
+        }
+    }
+
+    size_t GetThreadCount() const noexcept {
+        return workers_.size();
+    }
+
+    // Ставит задачу в очередь; задача не должна выбрасывать исключений
+    void Submit(std::function<void()> task) {
+        {
+            std::lock_guard guard(mutex_);
+            tasks_.push_back(std::move(task));
+        }
+        has_tasks_.notify_one();
+    }
+
+    // Сообщает, выполняется ли текущий код в потоке какого-либо пула
+    static bool IsWorkerThread() noexcept {
+        return is_worker_;
+    }
+
+private:
+    std::vector<std::thread> workers_;
+    std::mutex mutex_;
+    std::condition_variable has_tasks_;
+    std::deque<std::function<void()>> tasks_;
+    bool stopped_ = false;
+
+    static inline thread_local bool is_worker_ = false;
+
+    void Work() {
+        is_worker_ = true;
+        while (true) {
+            std::function<void()> task;
+            {
+                std::unique_lock lock(mutex_);
+                has_tasks_.wait(lock, [this] {
+                    return stopped_ || !tasks_.empty();
+                });
+                if (tasks_.empty()) {
+                    return;
+                }
+                task = std::move(tasks_.front());
+                tasks_.pop_front();
+            }
+            task();
+        }
+    }
+};
+
+// Глобальные настройки параллельного режима
+class ParallelExecution {
+public:
+    // Операции над блоками меньше этого размера всегда выполняются последовательно
+    static constexpr size_t kDefaultMinBytes = size_t{4} << 20;
+    // Меньшие куски не окупают передачу в другой поток
+    static constexpr size_t kMinChunkBytes = size_t{256} << 10;
+
+    // Включает параллельный режим с пулом из thread_count потоков.
+    // Вызывающий поток тоже обрабатывает свою часть, поэтому операция делится на thread_count + 1 частей
+    static void Enable(size_t thread_count = std::max(1u, std::thread::hardware_concurrency()) - 1,
+        size_t min_bytes = kDefaultMinBytes) {
+        std::shared_ptr<ThreadPool> pool = thread_count == 0 ? nullptr : std::make_shared<ThreadPool>(thread_count);
+        const size_t threshold = pool ? min_bytes : kDisabled;
+        std::lock_guard guard(State().mutex);
+        pool.swap(State().pool);
+        State().min_bytes.store(threshold, std::memory_order_relaxed);
+    }
+
+    // Выключает параллельный режим; пул останавливается, когда завершатся начатые операции
+    static void Disable() {
+        std::shared_ptr<ThreadPool> pool;
+        std::lock_guard guard(State().mutex);
+        State().min_bytes.store(kDisabled, std::memory_order_relaxed);
+        pool.swap(State().pool);
+    }
+
+    // Возвращает пул, если операцию над bytes байтами стоит выполнять параллельно, иначе nullptr
+    static std::shared_ptr<ThreadPool> PoolFor(size_t bytes) {
+        if (bytes < State().min_bytes.load(std::memory_order_relaxed) || ThreadPool::IsWorkerThread()) {
+            return nullptr;
+        }
+        std::lock_guard guard(State().mutex);
+        return State().pool;
+    }
+
+private:
+    static constexpr size_t kDisabled = static_cast<size_t>(-1);
+
+    struct Settings {
+        std::mutex mutex;
+        std::shared_ptr<ThreadPool> pool;
+        std::atomic<size_t> min_bytes{kDisabled};
+    };
+
+    static Settings& State() {
+        static Settings settings;
+        return settings;
+    }
+};
+
+// Число частей, на которые стоит делить операцию над count элементами размера element_size в пуле pool
+inline size_t ParallelChunkCount(const ThreadPool& pool, size_t count, size_t element_size) noexcept {
+    const size_t max_chunks = count * element_size / ParallelExecution::kMinChunkBytes;
+    return std::clamp<size_t>(max_chunks, 1, pool.GetThreadCount() + 1);
+}
+
+// Вызывает body(chunk) для каждого chunk из [0, chunks): первую часть — в вызывающем потоке,
+// остальные — в потоках pool (или все подряд, если pool == nullptr). Возвращает управление,
+// когда завершатся все части; первое из выброшенных частями исключений выбрасывается после этого.
+// Если пул не смог принять задачу, оставшиеся части выполняются в вызывающем потоке
+template <typename Body>
+void RunChunks(ThreadPool* pool, size_t chunks, const Body& body) {
+    std::exception_ptr error;
+    std::mutex error_mutex;
+    auto guarded = [&body, &error, &error_mutex](size_t chunk) noexcept {
+        try {
+            body(chunk);
+        }
+        catch (...) {
+            std::lock_guard guard(error_mutex);
+            if (!error) {
+                error = std::current_exception();
+            }
+        }
+    };
+    if (pool == nullptr || chunks <= 1) {
+        for (size_t chunk = 0; chunk < chunks; ++chunk) {
+            guarded(chunk);
+        }
+    }
+    else {
+        std::latch done(static_cast<std::ptrdiff_t>(chunks - 1));
+        for (size_t chunk = 1; chunk < chunks; ++chunk) {
+            try {
+                pool->Submit([&guarded, &done, chunk] {
+                    guarded(chunk);
+                    done.count_down();
+                });
+            }
+            catch (...) {
+                // Поставленные задачи ссылаются на guarded и done, поэтому выходить до done.wait() нельзя:
+                // части, которые не удалось поставить в очередь, выполняются здесь же
+                for (; chunk < chunks; ++chunk) {
+                    guarded(chunk);
+                    done.count_down();
+                }
+            }
+        }
+        guarded(0);
+        done.wait();
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+// Делит [0, count) на части и вызывает body(begin, end) для каждой, часть — в вызывающем потоке.
+// Выполняется последовательно, если блок меньше порога параллельного режима.
+// body не должен выбрасывать исключений
+template <typename Body>
+void ParallelFor(size_t count, size_t element_size, const Body& body) {
+    std::shared_ptr<ThreadPool> pool = ParallelExecution::PoolFor(count * element_size);
+    const size_t chunks = pool ? ParallelChunkCount(*pool, count, element_size) : 1;
+    if (chunks == 1) {
+        body(size_t{0}, count);
+        return;
+    }
+    const size_t chunk_size = (count + chunks - 1) / chunks;
+    RunChunks(pool.get(), chunks, [&body, count, chunk_size](size_t chunk) {
+        const size_t begin = std::min(count, chunk * chunk_size);
+        body(begin, std::min(count, begin + chunk_size));
+    });
+}
+
+// Параллельно делятся только операции, которые не выбрасывают исключений:
+// конструирование тривиально копируемых типов и сравнение скалярных
+template <typename Type>
+inline constexpr bool is_parallel_constructible_v = std::is_trivially_copyable_v<Type>;
+
+template <typename Type>
+inline constexpr bool is_parallel_comparable_v = std::is_scalar_v<Type>;
+
+template <typename Type>
+void ParallelUninitializedFill(Type* dest, size_t count, const Type& value) {
+    if constexpr (is_parallel_constructible_v<Type>) {
+        ParallelFor(count, sizeof(Type), [dest, &value](size_t begin, size_t end) {
+            std::uninitialized_fill(dest + begin, dest + end, value);
+        });
+    }
+    else {
+        std::uninitialized_fill_n(dest, count, value);
+    }
+}
+
+template <typename Type>
+void ParallelUninitializedValueConstruct(Type* dest, size_t count) {
+    if constexpr (is_parallel_constructible_v<Type> && std::is_nothrow_default_constructible_v<Type>) {
+        ParallelFor(count, sizeof(Type), [dest](size_t begin, size_t end) {
+            std::uninitialized_value_construct(dest + begin, dest + end);
+        });
+    }
+    else {
+        std::uninitialized_value_construct_n(dest, count);
+    }
+}
+
+template <typename Type>
+void ParallelUninitializedCopy(const Type* src, size_t count, Type* dest) {
+    if constexpr (is_parallel_constructible_v<Type>) {
+        ParallelFor(count, sizeof(Type), [src, dest](size_t begin, size_t end) {
+            std::uninitialized_copy(src + begin, src + end, dest + begin);
+        });
+    }
+    else {
+        std::uninitialized_copy_n(src, count, dest);
+    }
+}
+
+// Сравнивает count элементов lhs и rhs на равенство
+template <typename Type>
+bool ParallelEqual(const Type* lhs, const Type* rhs, size_t count) {
+    if constexpr (is_parallel_comparable_v<Type>) {
+        std::atomic<bool> equal{true};
+        ParallelFor(count, sizeof(Type), [lhs, rhs, &equal](size_t begin, size_t end) {
+            if (equal.load(std::memory_order_relaxed) && FirstUnequal(lhs + begin, rhs + begin, end - begin) != end - begin) {
+                equal.store(false, std::memory_order_relaxed);
+            }
+        });
+        return equal.load(std::memory_order_relaxed);
+    }
+    else {
+        return std::equal(lhs, lhs + count, rhs);
+    }
+}
+
+// Возвращает индекс первой пары элементов, из которых один меньше другого, или count.
+// Именно такая пара решает исход лексикографического сравнения
+template <typename Type>
+size_t ParallelFirstUnequivalent(const Type* lhs, const Type* rhs, size_t count) {
+    if constexpr (is_parallel_comparable_v<Type>) {
+        std::atomic<size_t> first{count};
+        ParallelFor(count, sizeof(Type), [lhs, rhs, &first](size_t begin, size_t end) {
+            // Части правее уже найденного различия можно не проверять
+            if (begin >= first.load(std::memory_order_relaxed)) {
+                return;
+            }
+            const size_t found = begin + FirstUnequivalent(lhs + begin, rhs + begin, end - begin);
+            if (found == end) {
+                return;
+            }
+            size_t current = first.load(std::memory_order_relaxed);
+            while (found < current && !first.compare_exchange_weak(current, found, std::memory_order_relaxed)) {
+            }
+        });
+        return first.load(std::memory_order_relaxed);
+    }
+    else {
+        return FirstUnequivalent(lhs, rhs, count);
+    }
+}
+
+// Лексикографически сравнивает [lhs, lhs + lhs_size) и [rhs, rhs + rhs_size)
+template <typename Type>
+bool ParallelLexicographicalLess(const Type* lhs, size_t lhs_size, const Type* rhs, size_t rhs_size) {
+    if constexpr (is_parallel_comparable_v<Type>) {
+        const size_t common = std::min(lhs_size, rhs_size);
+        const size_t index = ParallelFirstUnequivalent(lhs, rhs, common);
+        if (index < common) {
+            return lhs[index] < rhs[index];
+        }
+        return lhs_size < rhs_size;
+    }
+    else {
+        return std::lexicographical_compare(lhs, lhs + lhs_size, rhs, rhs + rhs_size);
+    }
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+
+// Тип тривиально перемещаем, если перенос объекта в другую память можно выполнить
+// побайтным копированием без вызова деструктора исходного объекта.
+// По умолчанию таковы тривиально копируемые типы; остальные типы могут
+// подтвердить это явно специализацией шаблона
+template <typename Type>
+struct IsTriviallyRelocatable : std::is_trivially_copyable<Type> {
+};
+
+template <typename Type>
+inline constexpr bool is_trivially_relocatable_v = IsTriviallyRelocatable<Type>::value;
+
+// Копирует ли UninitializedRelocate объекты вместо перемещения
+template <typename Type>
+inline constexpr bool relocates_by_copy_v = !is_trivially_relocatable_v<Type>
+    && !std::is_nothrow_move_constructible_v<Type> && std::is_copy_constructible_v<Type>;
+
+// Побайтно сдвигает count объектов из from в to; диапазоны могут перекрываться.
+// Объекты в from после вызова считаются сырой памятью
+template <typename Type>
+void RelocateBytes(Type* from, size_t count, Type* to) noexcept {
+    if (count != 0) {
+        std::memmove(static_cast<void*>(to), static_cast<const void*>(from), count * sizeof(Type));
+    }
+}
+
+// Переносит count живых объектов из from в сырую память to и разрушает исходные.
+// Если перемещение может выбросить исключение, а копирование доступно, объекты копируются,
+// и при исключении исходный диапазон остаётся нетронутым
+template <typename Type>
+void UninitializedRelocate(Type* from, size_t count, Type* to) {
+    if constexpr (is_trivially_relocatable_v<Type>) {
+        RelocateBytes(from, count, to);
+    }
+    else {
+        if constexpr (relocates_by_copy_v<Type>) {
+            std::uninitialized_copy_n(from, count, to);
+        }
+        else {
+            std::uninitialized_move_n(from, count, to);
+        }
+        std::destroy_n(from, count);
+    }
+}
@@ -0,0 +1,427 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <new>
+#include <span>
+#include <stdexcept>
+#include <utility>
+
+#include "allocator.h"
+#include "array_ptr.h"
+
+// Кольцевые буферы фиксированной вместимости на ArrayPtr: память выделяется один раз,
+// добавление в конец и удаление из начала стоят O(1) и не сдвигают элементы
+
+// Что делать с новым элементом, когда буфер заполнен
+enum class OverflowPolicy {
+    // Не принимать новый элемент
+    kReject,
+    // Заменить самый старый элемент
+    kOverwrite,
+};
+
+// Элементы кольцевого буфера в порядке от старых к новым: не больше двух непрерывных частей,
+// вторая начинается с начала памяти буфера, если первая упёрлась в её конец
+template <typename Type>
+struct RingSpans {
+    std::span<Type> first;
+    std::span<Type> second;
+
+    size_t GetSize() const noexcept {
+        return first.size() + second.size();
+    }
+};
+
+// Кольцевой буфер для одного потока
+template <typename Type, typename Allocator = MallocAllocator<Type>>
+class RingBuffer {
+public:
+    using AllocatorType = Allocator;
+
+    // Выбрасывает исключение std::invalid_argument, если capacity == 0
+    explicit RingBuffer(size_t capacity, OverflowPolicy policy = OverflowPolicy::kReject, const Allocator& alloc = Allocator())
+        : items_(capacity, RawMemoryTag{}, alloc)
+        , capacity_(capacity)
+        , policy_(policy) {
+        if (capacity == 0) {
+            throw std::invalid_argument("ring buffer capacity must be positive");
+        }
+    }
+
+    RingBuffer(const RingBuffer&) = delete;
+    RingBuffer& operator=(const RingBuffer&) = delete;
+
+    // Перемещённый буфер остаётся с нулевой вместимостью и политикой kReject:
+    // перезаписывать в нём нечего, и новые элементы просто отвергаются
+    RingBuffer(RingBuffer&& other) noexcept
+        : items_(std::move(other.items_))
+        , capacity_(std::exchange(other.capacity_, 0))
+        , head_(std::exchange(other.head_, 0))
+        , size_(std::exchange(other.size_, 0))
+        , policy_(std::exchange(other.policy_, OverflowPolicy::kReject)) {
+    }
+
+    RingBuffer& operator=(RingBuffer&& rhs) noexcept {
+        if (this != &rhs) {
+            Clear();
+            items_ = std::move(rhs.items_);
+            capacity_ = std::exchange(rhs.capacity_, 0);
+            head_ = std::exchange(rhs.head_, 0);
+            size_ = std::exchange(rhs.size_, 0);
+            policy_ = std::exchange(rhs.policy_, OverflowPolicy::kReject);
+        }
+        return *this;
+    }
+
+    ~RingBuffer() {
+        Clear();
+    }
+
+    size_t GetSize() const noexcept {
+        return size_;
+    }
+
+    size_t GetCapacity() const noexcept {
+        return capacity_;
+    }
+
+    bool IsEmpty() const noexcept {
+        return size_ == 0;
+    }
+
+    bool IsFull() const noexcept {
+        return size_ == capacity_;
+    }
+
+    OverflowPolicy GetPolicy() const noexcept {
+        return policy_;
+    }
+
+    // Элемент с индексом index, считая от самого старого
+    Type& operator[](size_t index) noexcept {
+        assert(index < size_);
+        return *Slot(index);
+    }
+
+    const Type& operator[](size_t index) const noexcept {
+        assert(index < size_);
+        return *Slot(index);
+    }
+
+    // Выбрасывает исключение std::out_of_range, если index >= size
+    Type& At(size_t index) {
+        if (index >= size_) {
+            throw std::out_of_range("out_of_range");
+        }
+        return *Slot(index);
+    }
+
+    const Type& At(size_t index) const {
+        if (index >= size_) {
+            throw std::out_of_range("out_of_range");
+        }
+        return *Slot(index);
+    }
+
+    Type& Front() noexcept {
+        return (*this)[0];
+    }
+
+    Type& Back() noexcept {
+        return (*this)[size_ - 1];
+    }
+
+    bool PushBack(const Type& item) {
+        return EmplaceBack(item);
+    }
+
+    bool PushBack(Type&& item) {
+        return EmplaceBack(std::move(item));
+    }
+
+    // Добавляет элемент в конец. Возвращает false, если буфер заполнен и новый элемент отвергнут
+    template <typename... Args>
+    bool EmplaceBack(Args&&... args) {
+        if (size_ < capacity_) {
+            new (Slot(size_)) Type(std::forward<Args>(args)...);
+            ++size_;
+            return true;
+        }
+        if (policy_ == OverflowPolicy::kReject) {
+            return false;
+        }
+        // В заполненном буфере место нового элемента занимает самый старый.
+        // Значение создаётся заранее: args могут ссылаться на заменяемый элемент
+        assert(capacity_ != 0);
+        Type value(std::forward<Args>(args)...);
+        *Slot(0) = std::move(value);
+        head_ = Wrap(head_ + 1);
+        return true;
+    }
+
+    // Копирует элементы items в конец не больше чем двумя непрерывными блоками.
+    // В режиме kReject добавляется столько, сколько помещается, в режиме kOverwrite — все,
+    // а самые старые элементы вытесняются. Возвращает число принятых элементов
+    size_t PushBatch(std::span<const Type> items) {
+        const size_t accepted = policy_ == OverflowPolicy::kOverwrite ? items.size() : std::min(items.size(), capacity_ - size_);
+        if (policy_ == OverflowPolicy::kOverwrite) {
+            if (items.size() >= capacity_) {
+                // Останутся только последние capacity элементов пачки
+                Clear();
+                items = items.last(capacity_);
+            }
+            else if (size_ + items.size() > capacity_) {
+                Consume(size_ + items.size() - capacity_);
+            }
+        }
+        const size_t count = std::min(items.size(), capacity_ - size_);
+        const size_t tail = Wrap(head_ + size_);
+        const size_t first = std::min(count, capacity_ - tail);
+        std::uninitialized_copy_n(items.data(), first, items_.Get() + tail);
+        try {
+            std::uninitialized_copy_n(items.data() + first, count - first, items_.Get());
+        }
+        catch (...) {
+            std::destroy_n(items_.Get() + tail, first);
+            throw;
+        }
+        size_ += count;
+        return accepted;
+    }
+
+    // Даёт доступ без копирования к max_count самым старым элементам.
+    // Элементы остаются в буфере, пока их не удалит Consume
+    RingSpans<Type> PeekBatch(size_t max_count = std::numeric_limits<size_t>::max()) noexcept {
+        const size_t count = std::min(max_count, size_);
+        const size_t first = std::min(count, capacity_ - head_);
+        return {{items_.Get() + head_, first}, {items_.Get(), count - first}};
+    }
+
+    // Удаляет count самых старых элементов
+    void Consume(size_t count) noexcept {
+        assert(count <= size_);
+        const size_t first = std::min(count, capacity_ - head_);
+        std::destroy_n(items_.Get() + head_, first);
+        std::destroy_n(items_.Get(), count - first);
+        head_ = Wrap(head_ + count);
+        size_ -= count;
+    }
+
+    // Перемещает самые старые элементы в out и удаляет их из буфера; возвращает их число
+    size_t PopBatch(std::span<Type> out) {
+        RingSpans<Type> spans = PeekBatch(out.size());
+        std::move(spans.first.begin(), spans.first.end(), out.begin());
+        std::move(spans.second.begin(), spans.second.end(), out.begin() + spans.first.size());
+        Consume(spans.GetSize());
+        return spans.GetSize();
+    }
+
+    // Перемещает самый старый элемент в out; возвращает false, если буфер пуст
+    bool TryPop(Type& out) {
+        if (size_ == 0) {
+            return false;
+        }
+        out = std::move(*Slot(0));
+        PopFront();
+        return true;
+    }
+
+    void PopFront() noexcept {
+        Consume(1);
+    }
+
+    void Clear() noexcept {
+        Consume(size_);
+        head_ = 0;
+    }
+
+private:
+    ArrayPtr<Type, Allocator> items_;
+    size_t capacity_ = 0;
+    // Индекс самого старого элемента
+    size_t head_ = 0;
+    size_t size_ = 0;
+    OverflowPolicy policy_ = OverflowPolicy::kReject;
+
+    // Приводит индекс из [0, 2 * capacity) к [0, capacity) без деления
+    size_t Wrap(size_t index) const noexcept {
+        return index >= capacity_ ? index - capacity_ : index;
+    }
+
+    Type* Slot(size_t index) const noexcept {
+        return items_.Get() + Wrap(head_ + index);
+    }
+};
+
+// Кольцевой буфер без блокировок для одного потока-производителя и одного потока-потребителя.
+// Вместимость округляется вверх до степени двойки, чтобы индекс вычислялся маской.
+// Счётчики записанных и прочитанных элементов лежат в разных строках кэша, и каждая сторона
+// хранит последнее увиденное значение чужого счётчика, обращаясь к нему, только когда места
+// (или элементов) не хватает. Перезаписи нет: самый старый элемент может в этот момент читать потребитель
+template <typename Type, typename Allocator = MallocAllocator<Type>>
+class SpscRingBuffer {
+public:
+    using AllocatorType = Allocator;
+
+    explicit SpscRingBuffer(size_t capacity, const Allocator& alloc = Allocator())
+        : capacity_(std::bit_ceil(std::max<size_t>(capacity, 1)))
+        , items_(capacity_, RawMemoryTag{}, alloc) {
+    }
+
+    SpscRingBuffer(const SpscRingBuffer&) = delete;
+    SpscRingBuffer& operator=(const SpscRingBuffer&) = delete;
+
+    // Разрушает непрочитанные элементы; к этому моменту оба потока должны закончить работу
+    ~SpscRingBuffer() {
+        const size_t head = consumer_.head.load(std::memory_order_relaxed);
+        const size_t tail = producer_.tail.load(std::memory_order_relaxed);
+        for (size_t i = head; i != tail; ++i) {
+            std::destroy_at(items_.Get() + (i & (capacity_ - 1)));
+        }
+    }
+
+    size_t GetCapacity() const noexcept {
+        return capacity_;
+    }
+
+    // Число элементов в буфере; при одновременной работе потоков — приблизительное
+    size_t GetSize() const noexcept {
+        const size_t head = consumer_.head.load(std::memory_order_acquire);
+        return producer_.tail.load(std::memory_order_acquire) - head;
+    }
+
+    bool IsEmpty() const noexcept {
+        return GetSize() == 0;
+    }
+
+    // Методы потока-производителя
+
+    bool TryPush(const Type& item) {
+        return TryEmplace(item);
+    }
+
+    bool TryPush(Type&& item) {
+        return TryEmplace(std::move(item));
+    }
+
+    // Добавляет элемент; возвращает false, если буфер заполнен
+    template <typename... Args>
+    bool TryEmplace(Args&&... args) {
+        const size_t tail = producer_.tail.load(std::memory_order_relaxed);
+        if (FreeSpace(tail) == 0) {
+            return false;
+        }
+        new (items_.Get() + (tail & (capacity_ - 1))) Type(std::forward<Args>(args)...);
+        producer_.tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Копирует столько элементов items, сколько помещается, и публикует их разом.
+    // Возвращает число добавленных элементов
+    size_t PushBatch(std::span<const Type> items) {
+        const size_t tail = producer_.tail.load(std::memory_order_relaxed);
+        const size_t count = std::min(items.size(), FreeSpace(tail, items.size()));
+        const size_t index = tail & (capacity_ - 1);
+        const size_t first = std::min(count, capacity_ - index);
+        std::uninitialized_copy_n(items.data(), first, items_.Get() + index);
+        try {
+            std::uninitialized_copy_n(items.data() + first, count - first, items_.Get());
+        }
+        catch (...) {
+            std::destroy_n(items_.Get() + index, first);
+            throw;
+        }
+        producer_.tail.store(tail + count, std::memory_order_release);
+        return count;
+    }
+
+    // Методы потока-потребителя
+
+    // Даёт доступ без копирования к max_count самым старым элементам; производитель их не трогает,
+    // пока потребитель не освободит их вызовом Consume
+    RingSpans<Type> PeekBatch(size_t max_count = std::numeric_limits<size_t>::max()) noexcept {
+        const size_t head = consumer_.head.load(std::memory_order_relaxed);
+        const size_t count = std::min(max_count, Available(head, max_count));
+        const size_t index = head & (capacity_ - 1);
+        const size_t first = std::min(count, capacity_ - index);
+        return {{items_.Get() + index, first}, {items_.Get(), count - first}};
+    }
+
+    // Удаляет count самых старых элементов, ранее показанных PeekBatch
+    void Consume(size_t count) noexcept {
+        const size_t head = consumer_.head.load(std::memory_order_relaxed);
+        assert(count <= consumer_.cached_tail - head);
+        for (size_t i = head; i != head + count; ++i) {
+            std::destroy_at(items_.Get() + (i & (capacity_ - 1)));
+        }
+        consumer_.head.store(head + count, std::memory_order_release);
+    }
+
+    // Перемещает самые старые элементы в out; возвращает их число
+    size_t PopBatch(std::span<Type> out) {
+        RingSpans<Type> spans = PeekBatch(out.size());
+        std::move(spans.first.begin(), spans.first.end(), out.begin());
+        std::move(spans.second.begin(), spans.second.end(), out.begin() + spans.first.size());
+        Consume(spans.GetSize());
+        return spans.GetSize();
+    }
+
+    // Перемещает самый старый элемент в out; возвращает false, если буфер пуст
+    bool TryPop(Type& out) {
+        RingSpans<Type> spans = PeekBatch(1);
+        if (spans.GetSize() == 0) {
+            return false;
+        }
+        out = std::move(spans.first[0]);
+        Consume(1);
+        return true;
+    }
+
+private:
+    // Размер строки кэша, по которому разносятся счётчики сторон
+    static constexpr size_t kCacheLine = 64;
+
+    // Данные потребителя: его счётчик и последний увиденный счётчик производителя
+    struct alignas(kCacheLine) ConsumerSide {
+        std::atomic<size_t> head{0};
+        size_t cached_tail = 0;
+    };
+
+    // Данные производителя: его счётчик и последний увиденный счётчик потребителя
+    struct alignas(kCacheLine) ProducerSide {
+        std::atomic<size_t> tail{0};
+        size_t cached_head = 0;
+    };
+
+    size_t capacity_;
+    ArrayPtr<Type, Allocator> items_;
+    ConsumerSide consumer_;
+    ProducerSide producer_;
+
+    // Свободное место для производителя; счётчик потребителя перечитывается, только если
+    // по сохранённому значению места меньше wanted
+    size_t FreeSpace(size_t tail, size_t wanted = 1) noexcept {
+        size_t free = capacity_ - (tail - producer_.cached_head);
+        if (free < wanted) {
+            producer_.cached_head = consumer_.head.load(std::memory_order_acquire);
+            free = capacity_ - (tail - producer_.cached_head);
+        }
+        return free;
+    }
+
+    // Число готовых элементов для потребителя, по тому же принципу
+    size_t Available(size_t head, size_t wanted) noexcept {
+        size_t available = consumer_.cached_tail - head;
+        if (available < wanted) {
+            consumer_.cached_tail = producer_.tail.load(std::memory_order_acquire);
+            available = consumer_.cached_tail - head;
+        }
+        return available;
+    }
+};
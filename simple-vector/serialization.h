@@ -0,0 +1,334 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#if __has_include(<fcntl.h>) && __has_include(<sys/mman.h>) && __has_include(<sys/stat.h>) && __has_include(<unistd.h>)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#error "serialization.h requires POSIX open/mmap for SimpleVectorView"
+#endif
+
+#include "simple_vector.h"
+
+// Двоичный формат векторов тривиально копируемых типов.
+// Файл состоит из заголовка BinaryVectorHeader размером kBinaryVectorHeaderSize байт
+// и следующих за ним элементов в представлении памяти текущей платформы.
+// Элементы начинаются со смещения, кратного 64, поэтому после mmap они выровнены
+// для любого типа с выравниванием до 64 байт
+
+inline constexpr uint32_t kBinaryVectorMagic = 0x43455653;  // "SVEC" в little-endian
+inline constexpr uint16_t kBinaryVectorVersion = 1;
+inline constexpr size_t kBinaryVectorHeaderSize = 64;
+// Порция чтения из потока, размер которого неизвестен: память выделяется по мере прихода данных
+inline constexpr size_t kBinaryReadChunkBytes = size_t{16} << 20;
+
+struct BinaryVectorHeader {
+    uint32_t magic = kBinaryVectorMagic;
+    uint16_t version = kBinaryVectorVersion;
+    uint16_t header_size = kBinaryVectorHeaderSize;
+    uint32_t element_size = 0;
+    uint32_t alignment = 0;
+    uint64_t count = 0;
+    uint64_t checksum = 0;
+};
+
+static_assert(sizeof(BinaryVectorHeader) <= kBinaryVectorHeaderSize);
+
+// Ошибка чтения или записи двоичного файла вектора
+class SerializationError : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
+// Контрольная сумма элементов: четыре независимые цепочки умножений по 8 байт,
+// чтобы подсчёт не упирался в задержку одного умножения
+inline uint64_t BinaryVectorChecksum(const void* data, size_t bytes) noexcept {
+    constexpr uint64_t kPrime = 0x9E3779B97F4A7C15;
+    const auto* ptr = static_cast<const unsigned char*>(data);
+    uint64_t lanes[4] = {bytes, kPrime, ~bytes, ~kPrime};
+    size_t i = 0;
+    for (; i + 32 <= bytes; i += 32) {
+        for (size_t lane = 0; lane < 4; ++lane) {
+            uint64_t word;
+            std::memcpy(&word, ptr + i + lane * 8, sizeof(word));
+            lanes[lane] = (lanes[lane] ^ word) * kPrime;
+            lanes[lane] ^= lanes[lane] >> 29;
+        }
+    }
+    uint64_t hash = lanes[0] ^ (lanes[1] << 1) ^ (lanes[2] << 2) ^ (lanes[3] << 3);
+    for (; i < bytes; ++i) {
+        hash = (hash ^ ptr[i]) * kPrime;
+    }
+    return hash ^ (hash >> 32);
+}
+
+// Проверяет, что заголовок описывает массив элементов типа Type, и возвращает число элементов
+template <typename Type>
+size_t CheckBinaryVectorHeader(const BinaryVectorHeader& header) {
+    if (header.magic != kBinaryVectorMagic) {
+        throw SerializationError("not a SimpleVector binary file or different byte order");
+    }
+    if (header.version != kBinaryVectorVersion || header.header_size != kBinaryVectorHeaderSize) {
+        throw SerializationError("unsupported SimpleVector binary format version " + std::to_string(header.version));
+    }
+    if (header.element_size != sizeof(Type) || header.alignment != alignof(Type)) {
+        throw SerializationError("element size or alignment does not match the requested type");
+    }
+    constexpr uint64_t kMaxBytes = std::min<uint64_t>(std::numeric_limits<size_t>::max(),
+        static_cast<uint64_t>(std::numeric_limits<std::streamsize>::max()));
+    if (header.count > kMaxBytes / sizeof(Type)) {
+        throw SerializationError("SimpleVector binary element count is too large");
+    }
+    return static_cast<size_t>(header.count);
+}
+
+// Число байт от текущей позиции до конца потока или -1, если поток не поддерживает позиционирование
+inline std::streamoff RemainingStreamBytes(std::istream& in) {
+    const std::istream::pos_type position = in.tellg();
+    if (position == std::istream::pos_type(-1)) {
+        return -1;
+    }
+    in.seekg(0, std::ios::end);
+    const std::istream::pos_type end = in.tellg();
+    in.clear();
+    in.seekg(position);
+    if (!in || end == std::istream::pos_type(-1)) {
+        in.clear();
+        return -1;
+    }
+    return end - position;
+}
+
+// Записывает элементы [data, data + count) в двоичном формате
+template <typename Type>
+void WriteBinary(std::ostream& out, const Type* data, size_t count) {
+    static_assert(std::is_trivially_copyable_v<Type>, "only trivially copyable types can be written as bytes");
+    static_assert(alignof(Type) <= kBinaryVectorHeaderSize, "elements must fit the alignment of the payload");
+    BinaryVectorHeader header;
+    header.element_size = sizeof(Type);
+    header.alignment = alignof(Type);
+    header.count = count;
+    header.checksum = BinaryVectorChecksum(data, count * sizeof(Type));
+
+    char raw_header[kBinaryVectorHeaderSize] = {};
+    std::memcpy(raw_header, &header, sizeof(header));
+    out.write(raw_header, sizeof(raw_header));
+    out.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(count * sizeof(Type)));
+    if (!out) {
+        throw SerializationError("failed to write SimpleVector binary data");
+    }
+}
+
+template <typename Type, typename Allocator, typename GrowthPolicy>
+void WriteBinary(std::ostream& out, const SimpleVector<Type, Allocator, GrowthPolicy>& vector) {
+    WriteBinary(out, vector.begin(), vector.GetSize());
+}
+
+// Читает вектор из двоичного формата одним блоком, без поэлементной вставки.
+// Число элементов из заголовка сверяется с длиной потока; если длина неизвестна,
+// элементы читаются порциями, так что повреждённый заголовок не приводит к огромному выделению.
+// Выбрасывает SerializationError, если данные повреждены или записаны для другого типа
+template <typename Type, typename Allocator = MallocAllocator<Type>, typename GrowthPolicy = DoublingGrowth>
+SimpleVector<Type, Allocator, GrowthPolicy> ReadBinary(std::istream& in, const Allocator& alloc = Allocator()) {
+    static_assert(std::is_trivially_copyable_v<Type>, "only trivially copyable types can be read as bytes");
+    char raw_header[kBinaryVectorHeaderSize];
+    BinaryVectorHeader header;
+    if (!in.read(raw_header, sizeof(raw_header))) {
+        throw SerializationError("truncated SimpleVector binary header");
+    }
+    std::memcpy(&header, raw_header, sizeof(header));
+    const size_t count = CheckBinaryVectorHeader<Type>(header);
+
+    const std::streamoff remaining = RemainingStreamBytes(in);
+    if (remaining >= 0 && static_cast<uint64_t>(remaining) / sizeof(Type) < count) {
+        throw SerializationError("truncated SimpleVector binary data");
+    }
+
+    SimpleVector<Type, Allocator, GrowthPolicy> result(alloc);
+    const size_t chunk = remaining >= 0 ? count : std::max<size_t>(kBinaryReadChunkBytes / sizeof(Type), 1);
+    result.Reserve(std::min(count, chunk));
+    while (result.GetSize() < count) {
+        const size_t begin = result.GetSize();
+        const size_t size = std::min(count - begin, chunk);
+        result.ResizeForOverwrite(begin + size);
+        if (!in.read(reinterpret_cast<char*>(result.begin() + begin), static_cast<std::streamsize>(size * sizeof(Type)))) {
+            throw SerializationError("truncated SimpleVector binary data");
+        }
+    }
+    if (BinaryVectorChecksum(result.begin(), count * sizeof(Type)) != header.checksum) {
+        throw SerializationError("SimpleVector binary data checksum mismatch");
+    }
+    return result;
+}
+
+template <typename Type, typename Allocator, typename GrowthPolicy>
+void SaveBinaryFile(const std::string& path, const SimpleVector<Type, Allocator, GrowthPolicy>& vector) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        throw SerializationError("cannot open " + path + " for writing");
+    }
+    WriteBinary(out, vector);
+}
+
+template <typename Type, typename Allocator = MallocAllocator<Type>, typename GrowthPolicy = DoublingGrowth>
+SimpleVector<Type, Allocator, GrowthPolicy> LoadBinaryFile(const std::string& path, const Allocator& alloc = Allocator()) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        throw SerializationError("cannot open " + path + " for reading");
+    }
+    return ReadBinary<Type, Allocator, GrowthPolicy>(in, alloc);
+}
+
+// Проверять ли контрольную сумму при открытии представления.
+// Проверка читает весь файл, поэтому для быстрого запуска её можно пропустить
+enum class ChecksumCheck {
+    kVerify,
+    kSkip,
+};
+
+// Неизменяемое представление вектора, записанного WriteBinary, поверх файла, отображённого в память.
+// Элементы не копируются: страницы файла подгружаются ядром при первом обращении
+template <typename Type>
+class SimpleVectorView {
+public:
+    static_assert(std::is_trivially_copyable_v<Type>, "only trivially copyable types can be viewed as bytes");
+
+    using ConstIterator = const Type*;
+
+    SimpleVectorView() noexcept = default;
+
+    explicit SimpleVectorView(const std::string& path, ChecksumCheck check = ChecksumCheck::kVerify) {
+        const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            throw SerializationError("cannot open " + path + " for reading");
+        }
+        struct stat file_stat {};
+        if (fstat(fd, &file_stat) != 0 || static_cast<size_t>(file_stat.st_size) < kBinaryVectorHeaderSize) {
+            close(fd);
+            throw SerializationError("truncated SimpleVector binary header in " + path);
+        }
+        mapped_size_ = static_cast<size_t>(file_stat.st_size);
+        void* mapped = mmap(nullptr, mapped_size_, PROT_READ, MAP_SHARED, fd, 0);
+        // Отображение остаётся действительным и после закрытия файла
+        close(fd);
+        if (mapped == MAP_FAILED) {
+            mapped_size_ = 0;
+            throw SerializationError("cannot map " + path);
+        }
+        mapped_ = mapped;
+        try {
+            Open(check);
+        }
+        catch (...) {
+            Unmap();
+            throw;
+        }
+    }
+
+    SimpleVectorView(const SimpleVectorView&) = delete;
+    SimpleVectorView& operator=(const SimpleVectorView&) = delete;
+
+    SimpleVectorView(SimpleVectorView&& other) noexcept
+        : mapped_(std::exchange(other.mapped_, nullptr))
+        , mapped_size_(std::exchange(other.mapped_size_, 0))
+        , data_(std::exchange(other.data_, nullptr))
+        , size_(std::exchange(other.size_, 0)) {
+    }
+
+    SimpleVectorView& operator=(SimpleVectorView&& rhs) noexcept {
+        if (this != &rhs) {
+            Unmap();
+            mapped_ = std::exchange(rhs.mapped_, nullptr);
+            mapped_size_ = std::exchange(rhs.mapped_size_, 0);
+            data_ = std::exchange(rhs.data_, nullptr);
+            size_ = std::exchange(rhs.size_, 0);
+        }
+        return *this;
+    }
+
+    ~SimpleVectorView() {
+        Unmap();
+    }
+
+    size_t GetSize() const noexcept {
+        return size_;
+    }
+
+    bool IsEmpty() const noexcept {
+        return size_ == 0;
+    }
+
+    const Type& operator[](size_t index) const noexcept {
+        assert(index < size_);
+        return data_[index];
+    }
+
+    // Выбрасывает исключение std::out_of_range, если index >= size
+    const Type& At(size_t index) const {
+        if (index >= size_) {
+            throw std::out_of_range("out_of_range");
+        }
+        return data_[index];
+    }
+
+    ConstIterator begin() const noexcept {
+        return data_;
+    }
+
+    ConstIterator end() const noexcept {
+        return data_ + size_;
+    }
+
+    ConstIterator cbegin() const noexcept {
+        return begin();
+    }
+
+    ConstIterator cend() const noexcept {
+        return end();
+    }
+
+private:
+    void* mapped_ = nullptr;
+    size_t mapped_size_ = 0;
+    const Type* data_ = nullptr;
+    size_t size_ = 0;
+
+    void Open(ChecksumCheck check) {
+        BinaryVectorHeader header;
+        std::memcpy(&header, mapped_, sizeof(header));
+        const size_t count = CheckBinaryVectorHeader<Type>(header);
+        if (count > (mapped_size_ - kBinaryVectorHeaderSize) / sizeof(Type)) {
+            throw SerializationError("truncated SimpleVector binary data");
+        }
+        data_ = reinterpret_cast<const Type*>(static_cast<const char*>(mapped_) + kBinaryVectorHeaderSize);
+        size_ = count;
+        if (check == ChecksumCheck::kVerify && BinaryVectorChecksum(data_, size_ * sizeof(Type)) != header.checksum) {
+            throw SerializationError("SimpleVector binary data checksum mismatch");
+        }
+    }
+
+    void Unmap() noexcept {
+        if (mapped_ != nullptr) {
+            munmap(mapped_, mapped_size_);
+        }
+        mapped_ = nullptr;
+        mapped_size_ = 0;
+        data_ = nullptr;
+        size_ = 0;
+    }
+};
@@ -0,0 +1,265 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+// Векторизованное сравнение массивов арифметических типов.
+// На x86 набор инструкций (SSE2 или AVX2) выбирается во время выполнения по возможностям процессора,
+// на остальных платформах используется скалярная версия
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define SIMPLE_VECTOR_X86_SIMD 1
+#include <immintrin.h>
+#else
+#define SIMPLE_VECTOR_X86_SIMD 0
+#endif
+
+enum class SimdLevel {
+    kScalar,
+    kSse2,
+    kAvx2,
+};
+
+class SimdCompare {
+public:
+    // Лучший набор инструкций, который поддерживает процессор
+    static SimdLevel GetSupportedLevel() noexcept {
+        static const SimdLevel supported = DetectLevel();
+        return supported;
+    }
+
+    static SimdLevel GetLevel() noexcept {
+        return Level().load(std::memory_order_relaxed);
+    }
+
+    // Ограничивает набор инструкций, например чтобы проверить каждую версию в тестах.
+    // Уровень выше поддерживаемого понижается; возвращает установленный уровень
+    static SimdLevel SetLevel(SimdLevel level) noexcept {
+        level = std::min(level, GetSupportedLevel());
+        Level().store(level, std::memory_order_relaxed);
+        return level;
+    }
+
+    // Возвращает смещение первого различающегося байта или bytes, если блоки совпадают
+    static size_t MismatchBytes(const void* lhs, const void* rhs, size_t bytes) noexcept {
+        const auto* l = static_cast<const unsigned char*>(lhs);
+        const auto* r = static_cast<const unsigned char*>(rhs);
+#if SIMPLE_VECTOR_X86_SIMD
+        switch (GetLevel()) {
+        case SimdLevel::kAvx2:
+            return MismatchBytesAvx2(l, r, bytes);
+        case SimdLevel::kSse2:
+            return MismatchBytesSse2(l, r, bytes);
+        case SimdLevel::kScalar:
+            break;
+        }
+#endif
+        return MismatchBytesScalar(l, r, bytes);
+    }
+
+    // Возвращает индекс первой пары чисел с плавающей точкой, для которой выполнено условие, или count.
+    // Ordered = false: !(lhs[i] == rhs[i]), то есть неравенство с учётом NaN.
+    // Ordered = true: lhs[i] < rhs[i] || rhs[i] < lhs[i]; пара с NaN при этом считается эквивалентной
+    template <typename Type, bool Ordered>
+    static size_t MismatchFloats(const Type* lhs, const Type* rhs, size_t count) noexcept {
+        static_assert(std::is_same_v<Type, float> || std::is_same_v<Type, double>);
+#if SIMPLE_VECTOR_X86_SIMD
+        switch (GetLevel()) {
+        case SimdLevel::kAvx2:
+            return MismatchFloatsAvx2<Type, Ordered>(lhs, rhs, count);
+        case SimdLevel::kSse2:
+            return MismatchFloatsSse2<Type, Ordered>(lhs, rhs, count);
+        case SimdLevel::kScalar:
+            break;
+        }
+#endif
+        return MismatchFloatsScalar<Type, Ordered>(lhs, rhs, count);
+    }
+
+private:
+    static std::atomic<SimdLevel>& Level() noexcept {
+        static std::atomic<SimdLevel> level{GetSupportedLevel()};
+        return level;
+    }
+
+    static SimdLevel DetectLevel() noexcept {
+#if SIMPLE_VECTOR_X86_SIMD
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) {
+            return SimdLevel::kAvx2;
+        }
+        if (__builtin_cpu_supports("sse2")) {
+            return SimdLevel::kSse2;
+        }
+#endif
+        return SimdLevel::kScalar;
+    }
+
+    static size_t MismatchBytesScalar(const unsigned char* lhs, const unsigned char* rhs, size_t bytes) noexcept {
+        size_t i = 0;
+        // По машинному слову за шаг; различающийся байт ищется уже внутри слова
+        for (; i + sizeof(uint64_t) <= bytes; i += sizeof(uint64_t)) {
+            uint64_t l;
+            uint64_t r;
+            std::memcpy(&l, lhs + i, sizeof(l));
+            std::memcpy(&r, rhs + i, sizeof(r));
+            if (l != r) {
+                if constexpr (std::endian::native == std::endian::little) {
+                    return i + std::countr_zero(l ^ r) / 8;
+                }
+                else {
+                    break;
+                }
+            }
+        }
+        for (; i < bytes && lhs[i] == rhs[i]; ++i) {
+        }
+        return i;
+    }
+
+    template <typename Type, bool Ordered>
+    static size_t MismatchFloatsScalar(const Type* lhs, const Type* rhs, size_t count) noexcept {
+        size_t i = 0;
+        for (; i < count; ++i) {
+            if (Ordered ? (lhs[i] < rhs[i] || rhs[i] < lhs[i]) : !(lhs[i] == rhs[i])) {
+                break;
+            }
+        }
+        return i;
+    }
+
+#if SIMPLE_VECTOR_X86_SIMD
+    // 32 байта за шаг
+    __attribute__((target("sse2")))
+    static size_t MismatchBytesSse2(const unsigned char* lhs, const unsigned char* rhs, size_t bytes) noexcept {
+        size_t i = 0;
+        for (; i + 32 <= bytes; i += 32) {
+            const __m128i eq0 = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(lhs + i)),
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(rhs + i)));
+            const __m128i eq1 = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(lhs + i + 16)),
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(rhs + i + 16)));
+            const uint32_t diff = ~(static_cast<uint32_t>(_mm_movemask_epi8(eq0))
+                | static_cast<uint32_t>(_mm_movemask_epi8(eq1)) << 16);
+            if (diff != 0) {
+                return i + std::countr_zero(diff);
+            }
+        }
+        return i + MismatchBytesScalar(lhs + i, rhs + i, bytes - i);
+    }
+
+    // 64 байта за шаг
+    __attribute__((target("avx2")))
+    static size_t MismatchBytesAvx2(const unsigned char* lhs, const unsigned char* rhs, size_t bytes) noexcept {
+        size_t i = 0;
+        for (; i + 64 <= bytes; i += 64) {
+            const __m256i eq0 = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(lhs + i)),
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rhs + i)));
+            const __m256i eq1 = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(lhs + i + 32)),
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rhs + i + 32)));
+            const uint64_t diff = ~(static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(eq0)))
+                | static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(eq1))) << 32);
+            if (diff != 0) {
+                return i + std::countr_zero(diff);
+            }
+        }
+        return i + MismatchBytesSse2(lhs + i, rhs + i, bytes - i);
+    }
+
+    // 32 байта за шаг
+    template <typename Type, bool Ordered>
+    __attribute__((target("sse2")))
+    static size_t MismatchFloatsSse2(const Type* lhs, const Type* rhs, size_t count) noexcept {
+        constexpr size_t kLanes = 16 / sizeof(Type);
+        size_t i = 0;
+        for (; i + 2 * kLanes <= count; i += 2 * kLanes) {
+            uint32_t mask = 0;
+            for (size_t half = 0; half < 2; ++half) {
+                const size_t offset = i + half * kLanes;
+                uint32_t half_mask;
+                if constexpr (std::is_same_v<Type, float>) {
+                    const __m128 l = _mm_loadu_ps(lhs + offset);
+                    const __m128 r = _mm_loadu_ps(rhs + offset);
+                    half_mask = _mm_movemask_ps(Ordered ? _mm_or_ps(_mm_cmplt_ps(l, r), _mm_cmplt_ps(r, l)) : _mm_cmpneq_ps(l, r));
+                }
+                else {
+                    const __m128d l = _mm_loadu_pd(lhs + offset);
+                    const __m128d r = _mm_loadu_pd(rhs + offset);
+                    half_mask = _mm_movemask_pd(Ordered ? _mm_or_pd(_mm_cmplt_pd(l, r), _mm_cmplt_pd(r, l)) : _mm_cmpneq_pd(l, r));
+                }
+                mask |= half_mask << (half * kLanes);
+            }
+            if (mask != 0) {
+                return i + std::countr_zero(mask);
+            }
+        }
+        return i + MismatchFloatsScalar<Type, Ordered>(lhs + i, rhs + i, count - i);
+    }
+
+    // 64 байта за шаг
+    template <typename Type, bool Ordered>
+    __attribute__((target("avx2")))
+    static size_t MismatchFloatsAvx2(const Type* lhs, const Type* rhs, size_t count) noexcept {
+        constexpr size_t kLanes = 32 / sizeof(Type);
+        // NEQ_OQ ложно для NaN, NEQ_UQ истинно
+        constexpr int kPredicate = Ordered ? _CMP_NEQ_OQ : _CMP_NEQ_UQ;
+        size_t i = 0;
+        for (; i + 2 * kLanes <= count; i += 2 * kLanes) {
+            uint32_t mask;
+            if constexpr (std::is_same_v<Type, float>) {
+                const uint32_t mask0 = _mm256_movemask_ps(_mm256_cmp_ps(_mm256_loadu_ps(lhs + i), _mm256_loadu_ps(rhs + i), kPredicate));
+                const uint32_t mask1 = _mm256_movemask_ps(_mm256_cmp_ps(_mm256_loadu_ps(lhs + i + kLanes), _mm256_loadu_ps(rhs + i + kLanes), kPredicate));
+                mask = mask0 | mask1 << kLanes;
+            }
+            else {
+                const uint32_t mask0 = _mm256_movemask_pd(_mm256_cmp_pd(_mm256_loadu_pd(lhs + i), _mm256_loadu_pd(rhs + i), kPredicate));
+                const uint32_t mask1 = _mm256_movemask_pd(_mm256_cmp_pd(_mm256_loadu_pd(lhs + i + kLanes), _mm256_loadu_pd(rhs + i + kLanes), kPredicate));
+                mask = mask0 | mask1 << kLanes;
+            }
+            if (mask != 0) {
+                return i + std::countr_zero(mask);
+            }
+        }
+        return i + MismatchFloatsSse2<Type, Ordered>(lhs + i, rhs + i, count - i);
+    }
+#endif
+};
+
+// Типы, для которых есть векторизованные версии сравнения.
+// Равенство целых совпадает с побайтным, поэтому все целые типы сравниваются одной функцией
+template <typename Type>
+inline constexpr bool is_simd_comparable_v = std::is_integral_v<Type>
+    || std::is_same_v<Type, float> || std::is_same_v<Type, double>;
+
+// Возвращает индекс первой пары, для которой !(lhs[i] == rhs[i]), или count
+template <typename Type>
+size_t FirstUnequal(const Type* lhs, const Type* rhs, size_t count) {
+    if constexpr (std::is_integral_v<Type>) {
+        return SimdCompare::MismatchBytes(lhs, rhs, count * sizeof(Type)) / sizeof(Type);
+    }
+    else if constexpr (is_simd_comparable_v<Type>) {
+        return SimdCompare::MismatchFloats<Type, false>(lhs, rhs, count);
+    }
+    else {
+        return std::mismatch(lhs, lhs + count, rhs).first - lhs;
+    }
+}
+
+// Возвращает индекс первой пары, в которой один элемент меньше другого, или count
+template <typename Type>
+size_t FirstUnequivalent(const Type* lhs, const Type* rhs, size_t count) {
+    if constexpr (std::is_integral_v<Type>) {
+        return SimdCompare::MismatchBytes(lhs, rhs, count * sizeof(Type)) / sizeof(Type);
+    }
+    else if constexpr (is_simd_comparable_v<Type>) {
+        return SimdCompare::MismatchFloats<Type, true>(lhs, rhs, count);
+    }
+    else {
+        return std::mismatch(lhs, lhs + count, rhs, [](const Type& a, const Type& b) {
+            return !(a < b) && !(b < a);
+        }).first - lhs;
+    }
+}
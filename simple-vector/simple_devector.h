@@ -0,0 +1,517 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <initializer_list>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <utility>
+
+#include "allocator.h"
+#include "array_ptr.h"
+#include "growth_policy.h"
+#include "parallel.h"
+#include "relocation.h"
+#include "vector_stats.h"
+
+// Двусторонний вектор: элементы лежат непрерывно в середине буфера, а свободное место есть
+// с обеих сторон, поэтому PushFront и PopFront, как и PushBack, стоят амортизированно O(1).
+// Insert и Erase сдвигают ту часть элементов, которая ближе к своему концу.
+// Если с нужной стороны места нет, а буфер заполнен не больше чем наполовину, элементы
+// сдвигаются внутри буфера, иначе переезжают в новый буфер, выбранный GrowthPolicy.
+// Итераторы — указатели, как у SimpleVector
+template <typename Type, typename AllocatorParam = MallocAllocator<Type>, typename GrowthPolicy = DoublingGrowth>
+class SimpleDevector {
+public:
+    using Allocator = resolve_allocator_t<Type, AllocatorParam>;
+    using Iterator = Type*;
+    using ConstIterator = const Type*;
+    using AllocatorType = Allocator;
+    using GrowthPolicyType = GrowthPolicy;
+
+    SimpleDevector() noexcept = default;
+
+    explicit SimpleDevector(const Allocator& alloc) noexcept
+        : buffer_(alloc) {
+    }
+
+    // Создаёт вектор из size элементов, инициализированных значением по умолчанию
+    explicit SimpleDevector(size_t size, const Allocator& alloc = Allocator())
+        : buffer_(size, RawMemoryTag{}, alloc) {
+        ParallelUninitializedValueConstruct(buffer_.Get(), size);
+        size_ = size;
+        capacity_ = size;
+        NoteAllocation(capacity_);
+    }
+
+    SimpleDevector(size_t size, const Type& value, const Allocator& alloc = Allocator())
+        : buffer_(size, RawMemoryTag{}, alloc) {
+        ParallelUninitializedFill(buffer_.Get(), size, value);
+        size_ = size;
+        capacity_ = size;
+        NoteAllocation(capacity_);
+    }
+
+    SimpleDevector(std::initializer_list<Type> init, const Allocator& alloc = Allocator())
+        : buffer_(init.size(), RawMemoryTag{}, alloc) {
+        std::uninitialized_copy(init.begin(), init.end(), buffer_.Get());
+        size_ = init.size();
+        capacity_ = size_;
+        NoteAllocation(capacity_);
+    }
+
+    SimpleDevector(const SimpleDevector& other)
+        : SimpleDevector(other, AllocTraits::select_on_container_copy_construction(other.GetAllocator())) {
+    }
+
+    // Копия занимает ровно size элементов, свободного места с краёв у неё нет
+    SimpleDevector(const SimpleDevector& other, const Allocator& alloc)
+        : buffer_(other.size_, RawMemoryTag{}, alloc) {
+        ParallelUninitializedCopy(other.begin(), other.size_, buffer_.Get());
+        size_ = other.size_;
+        capacity_ = size_;
+        NoteAllocation(capacity_);
+    }
+
+    SimpleDevector(SimpleDevector&& other) noexcept
+        : buffer_(std::move(other.buffer_))
+        , offset_(std::exchange(other.offset_, 0))
+        , size_(std::exchange(other.size_, 0))
+        , capacity_(std::exchange(other.capacity_, 0)) {
+    }
+
+    SimpleDevector& operator=(const SimpleDevector& rhs) {
+        if (this != &rhs) {
+            auto rhs_copy = AllocTraits::propagate_on_container_copy_assignment::value
+                ? SimpleDevector(rhs, rhs.GetAllocator())
+                : SimpleDevector(rhs, GetAllocator());
+            swap(rhs_copy);
+        }
+        return *this;
+    }
+
+    SimpleDevector& operator=(SimpleDevector&& rhs) noexcept(AllocTraits::propagate_on_container_move_assignment::value
+        || AllocTraits::is_always_equal::value) {
+        if (this != &rhs) {
+            if (AllocTraits::propagate_on_container_move_assignment::value || GetAllocator() == rhs.GetAllocator()) {
+                Clear();
+                buffer_ = std::move(rhs.buffer_);
+                offset_ = std::exchange(rhs.offset_, 0);
+                size_ = std::exchange(rhs.size_, 0);
+                capacity_ = std::exchange(rhs.capacity_, 0);
+            }
+            else {
+                // Память rhs принадлежит другому аллокатору: элементы переносятся поштучно
+                SimpleDevector rhs_moved(GetAllocator());
+                rhs_moved.Reserve(rhs.size_);
+                for (Type& item : rhs) {
+                    rhs_moved.EmplaceBack(std::move(item));
+                }
+                rhs.Clear();
+                swap(rhs_moved);
+            }
+        }
+        return *this;
+    }
+
+    ~SimpleDevector() {
+        Stats::OnDestroy(size_);
+        std::destroy_n(First(), size_);
+    }
+
+    Allocator GetAllocator() const noexcept {
+        return buffer_.GetAllocator();
+    }
+
+    size_t GetSize() const noexcept {
+        return size_;
+    }
+
+    // Вместимость всего буфера, вместе со свободным местом перед первым элементом
+    size_t GetCapacity() const noexcept {
+        return capacity_;
+    }
+
+    // Сколько элементов поместится перед первым без перевыделения
+    size_t GetFrontSpace() const noexcept {
+        return offset_;
+    }
+
+    // Сколько элементов поместится после последнего без перевыделения
+    size_t GetBackSpace() const noexcept {
+        return capacity_ - offset_ - size_;
+    }
+
+    bool IsEmpty() const noexcept {
+        return size_ == 0;
+    }
+
+    Type& operator[](size_t index) noexcept {
+        assert(index < size_);
+        return First()[index];
+    }
+
+    const Type& operator[](size_t index) const noexcept {
+        assert(index < size_);
+        return First()[index];
+    }
+
+    // Выбрасывает исключение std::out_of_range, если index >= size
+    Type& At(size_t index) {
+        if (index >= size_) {
+            throw std::out_of_range("out_of_range");
+        }
+        return First()[index];
+    }
+
+    const Type& At(size_t index) const {
+        if (index >= size_) {
+            throw std::out_of_range("out_of_range");
+        }
+        return First()[index];
+    }
+
+    // Увеличивает вместимость до new_capacity; место перед первым элементом сохраняется
+    void Reserve(size_t new_capacity) {
+        if (new_capacity > capacity_) {
+            Relocate(new_capacity, offset_, RelocationSite::kReserve);
+        }
+    }
+
+    // Гарантирует место под count элементов перед первым
+    void ReserveFront(size_t count) {
+        if (count > offset_) {
+            Relocate(capacity_ + count - offset_, count, RelocationSite::kReserve);
+        }
+    }
+
+    // Уменьшает вместимость до размера, убирая свободное место с обеих сторон
+    void ShrinkToFit() {
+        if (capacity_ > size_) {
+            Relocate(size_, 0, RelocationSite::kReserve);
+        }
+    }
+
+    // Разрушает элементы; освободившееся место остаётся за вектором
+    void Clear() noexcept {
+        std::destroy_n(First(), size_);
+        size_ = 0;
+        offset_ = 0;
+    }
+
+    // Изменяет размер, добавляя или удаляя элементы в конце
+    void Resize(size_t new_size) {
+        if (new_size > size_) {
+            EnsureBack(new_size - size_, RelocationSite::kReserve);
+            ParallelUninitializedValueConstruct(First() + size_, new_size - size_);
+        }
+        else {
+            std::destroy(First() + new_size, First() + size_);
+        }
+        size_ = new_size;
+    }
+
+    void PushBack(const Type& item) {
+        EmplaceBack(item);
+    }
+
+    void PushBack(Type&& item) {
+        EmplaceBack(std::move(item));
+    }
+
+    template <typename... Args>
+    Type& EmplaceBack(Args&&... args) {
+        if (GetBackSpace() == 0) {
+            // args могут ссылаться на элемент этого вектора, поэтому значение создаётся до переноса
+            Type value(std::forward<Args>(args)...);
+            EnsureBack(1, RelocationSite::kPushBack);
+            new (First() + size_) Type(std::move(value));
+        }
+        else {
+            new (First() + size_) Type(std::forward<Args>(args)...);
+        }
+        ++size_;
+        return First()[size_ - 1];
+    }
+
+    void PushFront(const Type& item) {
+        EmplaceFront(item);
+    }
+
+    void PushFront(Type&& item) {
+        EmplaceFront(std::move(item));
+    }
+
+    template <typename... Args>
+    Type& EmplaceFront(Args&&... args) {
+        if (offset_ == 0) {
+            Type value(std::forward<Args>(args)...);
+            EnsureFront(1, RelocationSite::kPushBack);
+            new (First() - 1) Type(std::move(value));
+        }
+        else {
+            new (First() - 1) Type(std::forward<Args>(args)...);
+        }
+        --offset_;
+        ++size_;
+        return *First();
+    }
+
+    // Удаляет последний элемент. Вектор не должен быть пустым
+    void PopBack() noexcept {
+        assert(!IsEmpty());
+        --size_;
+        std::destroy_at(First() + size_);
+    }
+
+    // Удаляет первый элемент. Вектор не должен быть пустым
+    void PopFront() noexcept {
+        assert(!IsEmpty());
+        std::destroy_at(First());
+        ++offset_;
+        --size_;
+    }
+
+    Iterator Insert(ConstIterator pos, const Type& value) {
+        return Emplace(pos, value);
+    }
+
+    Iterator Insert(ConstIterator pos, Type&& value) {
+        return Emplace(pos, std::move(value));
+    }
+
+    // Конструирует элемент в позиции pos, сдвигая элементы к ближайшему концу
+    template <typename... Args>
+    Iterator Emplace(ConstIterator pos, Args&&... args) {
+        assert(pos >= cbegin() && pos <= cend());
+        const size_t index = pos - cbegin();
+        // Временный объект защищает от args, ссылающихся на сдвигаемые элементы
+        Type value(std::forward<Args>(args)...);
+        if (index < size_ / 2) {
+            EnsureFront(1, RelocationSite::kInsert);
+            Type* first = First();
+            if constexpr (is_trivially_relocatable_v<Type>) {
+                RelocateBytes(first, index, first - 1);
+                new (first - 1 + index) Type(std::move(value));
+                --offset_;
+                ++size_;
+            }
+            else if (index == 0) {
+                new (first - 1) Type(std::move(value));
+                --offset_;
+                ++size_;
+            }
+            else {
+                new (first - 1) Type(std::move(*first));
+                --offset_;
+                ++size_;
+                std::move(first + 1, first + index, first);
+                first[index - 1] = std::move(value);
+            }
+        }
+        else {
+            EnsureBack(1, RelocationSite::kInsert);
+            Type* first = First();
+            Type* last = first + size_;
+            if constexpr (is_trivially_relocatable_v<Type>) {
+                RelocateBytes(first + index, size_ - index, first + index + 1);
+                new (first + index) Type(std::move(value));
+                ++size_;
+            }
+            else if (index == size_) {
+                new (last) Type(std::move(value));
+                ++size_;
+            }
+            else {
+                new (last) Type(std::move(*(last - 1)));
+                ++size_;
+                std::move_backward(first + index, last - 1, last);
+                first[index] = std::move(value);
+            }
+        }
+        return First() + index;
+    }
+
+    Iterator Erase(ConstIterator pos) {
+        assert(pos >= cbegin() && pos < cend());
+        return Erase(pos, pos + 1);
+    }
+
+    // Удаляет элементы [first, last), сдвигая ту часть оставшихся, которая короче
+    Iterator Erase(ConstIterator first, ConstIterator last) {
+        assert(cbegin() <= first && first <= last && last <= cend());
+        const size_t from = first - cbegin();
+        const size_t count = last - first;
+        if (count == 0) {
+            return First() + from;
+        }
+        Type* data = First();
+        const size_t after = size_ - from - count;
+        if (from < after) {
+            if constexpr (is_trivially_relocatable_v<Type>) {
+                std::destroy_n(data + from, count);
+                RelocateBytes(data, from, data + count);
+            }
+            else {
+                std::move_backward(data, data + from, data + from + count);
+                std::destroy_n(data, count);
+            }
+            offset_ += count;
+        }
+        else {
+            if constexpr (is_trivially_relocatable_v<Type>) {
+                std::destroy_n(data + from, count);
+                RelocateBytes(data + from + count, after, data + from);
+            }
+            else {
+                Type* new_end = std::move(data + from + count, data + size_, data + from);
+                std::destroy(new_end, data + size_);
+            }
+        }
+        size_ -= count;
+        return First() + from;
+    }
+
+    void swap(SimpleDevector& other) noexcept {
+        buffer_.swap(other.buffer_);
+        std::swap(offset_, other.offset_);
+        std::swap(size_, other.size_);
+        std::swap(capacity_, other.capacity_);
+    }
+
+    Iterator begin() noexcept {
+        return First();
+    }
+
+    Iterator end() noexcept {
+        return First() + size_;
+    }
+
+    ConstIterator begin() const noexcept {
+        return First();
+    }
+
+    ConstIterator end() const noexcept {
+        return First() + size_;
+    }
+
+    ConstIterator cbegin() const noexcept {
+        return First();
+    }
+
+    ConstIterator cend() const noexcept {
+        return First() + size_;
+    }
+
+private:
+    using AllocTraits = std::allocator_traits<Allocator>;
+    using Stats = VectorStats<SimpleDevector>;
+
+    ArrayPtr<Type, Allocator> buffer_{Allocator()};
+    // Число свободных ячеек перед первым элементом
+    size_t offset_{};
+    size_t size_{};
+    size_t capacity_{};
+
+    Type* First() const noexcept {
+        return buffer_.Get() + offset_;
+    }
+
+    // Вместимость для required элементов: если буфер заполнен не больше чем наполовину,
+    // элементы выгоднее сдвинуть внутри него, иначе буфер растёт по политике роста
+    size_t CapacityFor(size_t required) const noexcept {
+        if (required <= capacity_ / 2) {
+            return capacity_;
+        }
+        const size_t capacity = GrowthPolicy::NextCapacity(capacity_, required, sizeof(Type));
+        assert(capacity >= required);
+        return capacity;
+    }
+
+    // Освобождает место под count элементов перед первым. Половина свободного места остаётся позади,
+    // но не больше, чем там было: при одном PushFront позади ничего не резервируется
+    void EnsureFront(size_t count, RelocationSite site) {
+        if (offset_ >= count) {
+            return;
+        }
+        const size_t capacity = CapacityFor(size_ + count);
+        const size_t back = std::min(GetBackSpace(), (capacity - size_ - count) / 2);
+        Relocate(capacity, capacity - back - size_, site);
+    }
+
+    // Освобождает место под count элементов после последнего, зеркально EnsureFront
+    void EnsureBack(size_t count, RelocationSite site) {
+        if (GetBackSpace() >= count) {
+            return;
+        }
+        const size_t capacity = CapacityFor(size_ + count);
+        Relocate(capacity, std::min(offset_, (capacity - size_ - count) / 2), site);
+    }
+
+    // Переносит элементы в буфер вместимостью new_capacity, начиная с ячейки new_offset.
+    // Тривиально перемещаемые элементы сдвигаются memmove, а буфер меняет размер через Reallocate;
+    // остальные переезжают в новый буфер, даже если вместимость не меняется
+    void Relocate(size_t new_capacity, size_t new_offset, RelocationSite site) {
+        assert(new_offset + size_ <= new_capacity);
+        if constexpr (is_trivially_relocatable_v<Type>) {
+            // Сдвиг к началу выполняется до сжатия буфера, сдвиг к концу — после расширения
+            if (new_offset < offset_) {
+                RelocateBytes(First(), size_, buffer_.Get() + new_offset);
+            }
+            if (new_capacity != capacity_) {
+                buffer_.Reallocate(new_capacity);
+                NoteAllocation(new_capacity);
+            }
+            if (new_offset > offset_) {
+                RelocateBytes(First(), size_, buffer_.Get() + new_offset);
+            }
+        }
+        else {
+            ArrayPtr<Type, Allocator> new_buffer(new_capacity, RawMemoryTag{}, buffer_.GetAllocator());
+            UninitializedRelocate(First(), size_, new_buffer.Get() + new_offset);
+            buffer_.swap(new_buffer);
+            NoteAllocation(new_capacity);
+        }
+        Stats::OnRelocate(site, size_, relocates_by_copy_v<Type>);
+        offset_ = new_offset;
+        capacity_ = new_capacity;
+    }
+
+    static void NoteAllocation(size_t capacity) noexcept {
+        if (capacity != 0) {
+            Stats::OnAllocate(capacity, capacity * sizeof(Type));
+        }
+    }
+};
+
+template <typename Type, typename Allocator, typename GrowthPolicy>
+bool operator==(const SimpleDevector<Type, Allocator, GrowthPolicy>& lhs, const SimpleDevector<Type, Allocator, GrowthPolicy>& rhs) {
+    return lhs.GetSize() == rhs.GetSize() && ParallelEqual(lhs.begin(), rhs.begin(), lhs.GetSize());
+}
+
+template <typename Type, typename Allocator, typename GrowthPolicy>
+bool operator!=(const SimpleDevector<Type, Allocator, GrowthPolicy>& lhs, const SimpleDevector<Type, Allocator, GrowthPolicy>& rhs) {
+    return !(lhs == rhs);
+}
+
+template <typename Type, typename Allocator, typename GrowthPolicy>
+bool operator<(const SimpleDevector<Type, Allocator, GrowthPolicy>& lhs, const SimpleDevector<Type, Allocator, GrowthPolicy>& rhs) {
+    return ParallelLexicographicalLess(lhs.begin(), lhs.GetSize(), rhs.begin(), rhs.GetSize());
+}
+
+template <typename Type, typename Allocator, typename GrowthPolicy>
+bool operator<=(const SimpleDevector<Type, Allocator, GrowthPolicy>& lhs, const SimpleDevector<Type, Allocator, GrowthPolicy>& rhs) {
+    return !(rhs < lhs);
+}
+
+template <typename Type, typename Allocator, typename GrowthPolicy>
+bool operator>(const SimpleDevector<Type, Allocator, GrowthPolicy>& lhs, const SimpleDevector<Type, Allocator, GrowthPolicy>& rhs) {
+    return rhs < lhs;
+}
+
+template <typename Type, typename Allocator, typename GrowthPolicy>
+bool operator>=(const SimpleDevector<Type, Allocator, GrowthPolicy>& lhs, const SimpleDevector<Type, Allocator, GrowthPolicy>& rhs) {
+    return !(lhs < rhs);
+}
@@ -4,10 +4,38 @@
 #include <cassert>
 #include <initializer_list>
 #include <iostream>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <ranges>
+#include <span>
 #include <stdexcept>
+#include <type_traits>
 #include <utility>
 
+#include "allocator.h"
 #include "array_ptr.h"
+#include "growth_policy.h"
+#include "parallel.h"
+#include "relocation.h"
+#include "vector_stats.h"
+
+// Итераторы, по которым длину диапазона можно узнать заранее и затем пройти его ещё раз.
+// std::move_iterator в C++20 объявлен однопроходным, но над многопроходным итератором проходит диапазон повторно
+template <typename Iterator>
+inline constexpr bool is_multipass_iterator_v = std::forward_iterator<Iterator>;
+
+template <typename Iterator>
+inline constexpr bool is_multipass_iterator_v<std::move_iterator<Iterator>> = std::forward_iterator<Iterator>;
+
+// Буфер, который вектор отдал методом Release: живые элементы [0, size) в памяти под capacity элементов
+template <typename Type>
+struct ReleasedBuffer {
+    Type* data = nullptr;
+    size_t size = 0;
+    size_t capacity = 0;
+};
 
 class ReserveProxyObj {
 public:
@@ -16,46 +44,114 @@ public:
     size_t capacity_{};
 };
 
-template <typename Type>
+// Память вектора выделяется без конструирования элементов:
+// живыми считаются только элементы в диапазоне [0, size_),
+// ячейки [size_, GetCapacity()) — сырая память. Вместимость хранит сам ArrayPtr.
+// Тривиально перемещаемые типы переносятся через memmove, а память растёт через realloc,
+// если аллокатор это поддерживает.
+// Вся память берётся у аллокатора Allocator; подходит и std::pmr::polymorphic_allocator.
+// Вместо аллокатора можно указать Align<N>: память берётся у AlignedAllocator и начало
+// элементов выровнено на N байт при любом перевыделении (см. allocator.h).
+// Новую вместимость при росте выбирает GrowthPolicy (см. growth_policy.h)
+template <typename Type, typename AllocatorParam = MallocAllocator<Type>, typename GrowthPolicy = DoublingGrowth>
 class SimpleVector {
 public:
+    using Allocator = resolve_allocator_t<Type, AllocatorParam>;
     using Iterator = Type*;
     using ConstIterator = const Type*;
+    using AllocatorType = Allocator;
+    using GrowthPolicyType = GrowthPolicy;
 
     SimpleVector() noexcept = default;
 
+    // Создаёт пустой вектор, берущий память у аллокатора alloc
+    explicit SimpleVector(const Allocator& alloc) noexcept :simpleVector_(alloc) {
+    }
+
     // Создаёт вектор из size элементов, инициализированных значением по умолчанию
-    explicit SimpleVector(size_t size) :SimpleVector(size, Type{}) {
+    explicit SimpleVector(size_t size, const Allocator& alloc = Allocator()) :simpleVector_(size, RawMemoryTag{}, alloc) {
+        ParallelUninitializedValueConstruct(simpleVector_.Get(), size);
+        size_ = size;
+        NoteAllocation(size);
     }
 
     // Создаёт вектор из size элементов, инициализированных значением value
-    SimpleVector(size_t size, const Type& value) {
-        ArrayPtr<Type> simpleVector(size);
-        simpleVector_.swap(simpleVector);
-        std::fill(simpleVector_.Get(), simpleVector_.Get() + size, value);
+    SimpleVector(size_t size, const Type& value, const Allocator& alloc = Allocator()) :simpleVector_(size, RawMemoryTag{}, alloc) {
+        ParallelUninitializedFill(simpleVector_.Get(), size, value);
         size_ = size;
-        capacity_ = size;
+        NoteAllocation(size);
     }
 
     // Создаёт вектор из std::initializer_list
-    SimpleVector(std::initializer_list<Type> init) {
-        ArrayPtr<Type> tmp1(init.size());
+    SimpleVector(std::initializer_list<Type> init, const Allocator& alloc = Allocator()) :simpleVector_(init.size(), RawMemoryTag{}, alloc) {
+        std::uninitialized_copy(init.begin(), init.end(), simpleVector_.Get());
         size_ = init.size();
-        std::copy(init.begin(), init.end(), tmp1.Get());
-        simpleVector_.swap(tmp1);
-        capacity_ = size_;
+        NoteAllocation(size_);
     }
 
-    SimpleVector(ReserveProxyObj t) {
+    SimpleVector(ReserveProxyObj t, const Allocator& alloc = Allocator()) :simpleVector_(alloc) {
         Reserve(t.capacity_);
     }
 
+    ~SimpleVector() {
+        Stats::OnDestroy(size_);
+        std::destroy_n(simpleVector_.Get(), size_);
+    }
+
+    // Забирает внешний буфер data вместимостью capacity элементов без копирования.
+    // Элементы [0, size) в нём уже должны быть сконструированы, дальше ими владеет вектор.
+    // Память освобождается вызовом deleter(data) или deleter(data, capacity) при разрушении вектора
+    // или когда элементы переезжают в память аллокатора при росте
+    template <typename Deleter>
+        requires std::is_invocable_v<Deleter&, Type*> || std::is_invocable_v<Deleter&, Type*, size_t>
+    static SimpleVector Adopt(Type* data, size_t size, size_t capacity, Deleter deleter, const Allocator& alloc = Allocator()) {
+        assert(size <= capacity);
+        ArrayPtr<Type, Allocator> buffer(data, capacity, std::move(deleter), alloc);
+        return SimpleVector(std::move(buffer), size);
+    }
+
+    // Забирает буфер, выделенный аллокатором alloc, например полученный от Release
+    static SimpleVector Adopt(Type* data, size_t size, size_t capacity, const Allocator& alloc = Allocator()) {
+        assert(size <= capacity);
+        ArrayPtr<Type, Allocator> buffer(data, capacity, RawMemoryTag{}, alloc);
+        return SimpleVector(std::move(buffer), size);
+    }
+
+    // Отдаёт буфер вместе с живыми элементами и оставляет вектор пустым.
+    // Разрушить элементы и освободить память должен вызывающий: память аллокатора —
+    // через GetAllocator().deallocate(data, capacity), буфер из Adopt с deleter — тем способом,
+    // которым он был получен (deleter при этом не вызывается)
+    [[nodiscard]] ReleasedBuffer<Type> Release() noexcept {
+        const size_t capacity = GetCapacity();
+        ReleasedBuffer<Type> buffer{simpleVector_.Release(), size_, capacity};
+        size_ = 0;
+        return buffer;
+    }
+
+    // Представление элементов [first, last) без копирования.
+    // Действительно, пока вектор не перевыделяет память и не удаляет эти элементы.
+    // Выбрасывает исключение std::out_of_range, если first > last или last > size
+    std::span<Type> Slice(size_t first, size_t last) {
+        CheckSlice(first, last);
+        return {simpleVector_.Get() + first, last - first};
+    }
+
+    std::span<const Type> Slice(size_t first, size_t last) const {
+        CheckSlice(first, last);
+        return {simpleVector_.Get() + first, last - first};
+    }
+
+    // Выделяет память под new_capacity элементов, не конструируя новых
     void Reserve(size_t new_capacity) {
-        if (new_capacity > capacity_) {
-            ArrayPtr<Type> new_array(new_capacity);
-            std::copy(simpleVector_.Get(), simpleVector_.Get() + size_, new_array.Get());
-            simpleVector_.swap(new_array);
-            capacity_ = new_capacity;
+        if (new_capacity > GetCapacity()) {
+            Relocation(new_capacity);
+        }
+    }
+
+    // Уменьшает вместимость до текущего размера, возвращая лишнюю память аллокатору
+    void ShrinkToFit() {
+        if (GetCapacity() > size_) {
+            Relocation(size_);
         }
     }
 
@@ -66,7 +162,7 @@ public:
 
     // Возвращает вместимость массива
     size_t GetCapacity() const noexcept {
-        return capacity_;
+        return simpleVector_.GetSize();
     }
 
     // Сообщает, пустой ли массив
@@ -106,57 +202,88 @@ public:
         return  simpleVector_[index];
     }
 
-    // Обнуляет размер массива, не изменяя его вместимость
+    // Разрушает элементы и обнуляет размер массива, не изменяя его вместимость
     void Clear() noexcept {
+        std::destroy_n(simpleVector_.Get(), size_);
         size_ = 0;
     }
 
     // Изменяет размер массива.
-   // При увеличении размера новые элементы получают значение по умолчанию для типа Type
+    // При увеличении размера новые элементы получают значение по умолчанию для типа Type,
+    // при уменьшении лишние элементы разрушаются
     void Resize(size_t new_size) {
-        if (new_size <= capacity_) {
-            std::fill(simpleVector_.Get() + size_, simpleVector_.Get() + capacity_, Type());
-            size_ = new_size;
-        }
-        if (new_size > capacity_) {
-            size_t old_size = size_;
-            if (new_size > 2 * capacity_) {
-                Relocation(new_size);
-            }
-            if (new_size <= 2 * capacity_) {
-                Relocation(2 * capacity_);
-            }
-            std::fill(simpleVector_.Get() + old_size, simpleVector_.Get() + capacity_, Type());
+        if (new_size > GetCapacity()) {
+            Relocation(GrowCapacity(new_size));
+        }
+        if (new_size > size_) {
+            ParallelUninitializedValueConstruct(simpleVector_.Get() + size_, new_size - size_);
+        }
+        else {
+            std::destroy(simpleVector_.Get() + new_size, simpleVector_.Get() + size_);
         }
         size_ = new_size;
     }
 
-    SimpleVector(SimpleVector&& other) {
-        simpleVector_.swap(other.simpleVector_);
+    // Изменяет размер как Resize, но новые элементы инициализируются по умолчанию, а не значением.
+    // Для тривиальных типов их содержимое не определено: вызывающий обязан сразу их перезаписать,
+    // зато память не заполняется нулями перед записью, например при чтении из файла
+    void ResizeForOverwrite(size_t new_size) {
+        if (new_size > GetCapacity()) {
+            Relocation(GrowCapacity(new_size));
+        }
+        if (new_size > size_) {
+            std::uninitialized_default_construct(simpleVector_.Get() + size_, simpleVector_.Get() + new_size);
+        }
+        else {
+            std::destroy(simpleVector_.Get() + new_size, simpleVector_.Get() + size_);
+        }
+        size_ = new_size;
+    }
+
+    SimpleVector(SimpleVector&& other) noexcept :simpleVector_(std::move(other.simpleVector_)) {
         size_ = std::exchange(other.size_, 0);
-        capacity_ = std::exchange(other.capacity_, 0);
     }
 
-    SimpleVector& operator=(SimpleVector&& rhs) {
-        simpleVector_.swap(rhs.simpleVector_);
-        size_ = std::exchange(rhs.size_, 0);
-        capacity_ = std::exchange(rhs.capacity_, 0);
+    SimpleVector& operator=(SimpleVector&& rhs) noexcept(AllocTraits::propagate_on_container_move_assignment::value
+        || AllocTraits::is_always_equal::value) {
+        if (this != &rhs) {
+            if (AllocTraits::propagate_on_container_move_assignment::value || GetAllocator() == rhs.GetAllocator()) {
+                // Прежние элементы разрушаются, память забирается у rhs целиком
+                Clear();
+                simpleVector_ = std::move(rhs.simpleVector_);
+                size_ = std::exchange(rhs.size_, 0);
+            }
+            else {
+                // Память rhs принадлежит другому аллокатору: элементы переносятся поштучно
+                SimpleVector rhs_moved(GetAllocator());
+                rhs_moved.Reserve(rhs.size_);
+                for (Type& item : rhs) {
+                    rhs_moved.EmplaceBack(std::move(item));
+                }
+                rhs.Clear();
+                swap(rhs_moved);
+            }
+        }
         return *this;
     }
 
-    SimpleVector(const SimpleVector& other) {
-        ArrayPtr<Type> tmp1(other.GetSize());
+    SimpleVector(const SimpleVector& other)
+        :SimpleVector(other, AllocTraits::select_on_container_copy_construction(other.GetAllocator())) {
+    }
+
+    SimpleVector(const SimpleVector& other, const Allocator& alloc) :simpleVector_(other.GetSize(), RawMemoryTag{}, alloc) {
+        ParallelUninitializedCopy(other.begin(), other.GetSize(), simpleVector_.Get());
         size_ = other.GetSize();
-        std::copy(other.begin(), other.end(), tmp1.Get());
-        simpleVector_.swap(tmp1);
-        capacity_ = size_;
+        NoteAllocation(size_);
     }
 
     SimpleVector& operator=(const SimpleVector& rhs) {
         if (this != &rhs) {
             // Реализация операции присваивания с помощью идиомы Copy-and-swap
             // Если исключение будет выброшено, то на текущий объект оно не повлияет
-            auto rhs_copy(rhs);
+            auto rhs_copy = AllocTraits::propagate_on_container_copy_assignment::value
+                ? SimpleVector(rhs, rhs.GetAllocator())
+                : SimpleVector(rhs, GetAllocator());
             // rhs_copy содержит копию правого аргумента
             // Обмениваемся с ним данными
            // this->swap(rhs_copy);
@@ -168,157 +295,230 @@ public:
         return *this;
     }
 
+    // Возвращает аллокатор вектора
+    Allocator GetAllocator() const noexcept {
+        return simpleVector_.GetAllocator();
+    }
+
     // Добавляет элемент в конец вектора
-    // При нехватке места увеличивает вдвое вместимость вектора
+    // При нехватке места увеличивает вместимость по политике роста
     void PushBack(const Type& item) {
-        if (size_ < capacity_) {
-            simpleVector_[size_] = item;
-            ++size_;
-        }
-        else {
-            size_t capacity{};
-            if (capacity_ == 0) {
-                capacity = 1;
-            }
-            else {
-                capacity = 2 * capacity_;
-            }
-            ArrayPtr<Type> new_array(capacity);
-            std::copy(simpleVector_.Get(), simpleVector_.Get() + size_, new_array.Get());
-            simpleVector_.swap(new_array);
-            simpleVector_[size_] = item;
-            ++size_;
-            capacity_ = capacity;
-        }
+        EmplaceBack(item);
     }
 
     void PushBack(Type&& item) {
-        if (size_ < capacity_) {
-            simpleVector_[size_] = std::move(item);
-            ++size_;
+        EmplaceBack(std::move(item));
+    }
+
+    // Конструирует элемент из аргументов args прямо в конце вектора.
+    // При нехватке места увеличивает вместимость по политике роста
+    template <typename... Args>
+    Type& EmplaceBack(Args&&... args) {
+        if (size_ < GetCapacity()) {
+            new (simpleVector_.Get() + size_) Type(std::forward<Args>(args)...);
+        }
+        else if constexpr (is_trivially_relocatable_v<Type>) {
+            // Блок может переехать при realloc, поэтому значение создаётся заранее
+            Type value(std::forward<Args>(args)...);
+            Relocation(NextCapacity(), RelocationSite::kPushBack);
+            new (simpleVector_.Get() + size_) Type(std::move(value));
         }
         else {
-            size_t capacity{};
-            if (capacity_ == 0) {
-                capacity = 1;
+            const size_t capacity = NextCapacity();
+            ArrayPtr<Type, Allocator> new_array(capacity, RawMemoryTag{}, simpleVector_.GetAllocator());
+            // Новый элемент создаётся до переноса старых: args могут ссылаться на элемент этого вектора
+            new (new_array.Get() + size_) Type(std::forward<Args>(args)...);
+            try {
+                UninitializedRelocate(simpleVector_.Get(), size_, new_array.Get());
             }
-            else {
-                capacity = 2 * capacity_;
+            catch (...) {
+                std::destroy_at(new_array.Get() + size_);
+                throw;
             }
-            ArrayPtr<Type> new_array(capacity);
-            std::move(std::make_move_iterator(simpleVector_.Get()), std::make_move_iterator(simpleVector_.Get() + size_), new_array.Get());
+            NoteAllocation(capacity);
+            NoteRelocation(RelocationSite::kPushBack, size_);
             simpleVector_.swap(new_array);
-            simpleVector_[size_] = std::move(item);
-            ++size_;
-            capacity_ = capacity;
         }
+        ++size_;
+        return simpleVector_[size_ - 1];
     }
 
     // Вставляет значение value в позицию pos.
     // Возвращает итератор на вставленное значение
     // Если перед вставкой значения вектор был заполнен полностью,
-    // вместимость вектора должна увеличиться вдвое, а для вектора вместимостью 0 стать равной 1
+    // вместимость вектора увеличивается по политике роста (по умолчанию вдвое, а с 0 до 1)
     Iterator Insert(ConstIterator pos, const Type& value) {
+        return Emplace(pos, value);
+    }
+
+    Iterator Insert(ConstIterator pos, Type&& value) {
+        return Emplace(pos, std::move(value));
+    }
+
+    // Конструирует элемент из аргументов args в позиции pos.
+    // Возвращает итератор на вставленное значение
+    template <typename... Args>
+    Iterator Emplace(ConstIterator pos, Args&&... args) {
         assert(pos >= cbegin() && pos <= cend());
-        size_t capacity{};
-        if (capacity_ == 0) {
-            capacity_ = 1;
-            ++size_;
-            ArrayPtr<Type> simpleVector(1);
-            simpleVector_.swap(simpleVector);
-            simpleVector_[0] = value;
-            return simpleVector_.Get();
-        }
-        else if (size_ == capacity_) {
-            capacity = 2 * capacity_;
-            ArrayPtr<Type> new_array(capacity);
-            std::copy(simpleVector_.Get(), pos, new_array.Get());
-            Iterator new_pos = new_array.Get();
-            Iterator begin_old = simpleVector_.Get();
-            while (begin_old != pos) {
-                ++begin_old;
-                ++new_pos;
+        const size_t index = pos - cbegin();
+        if constexpr (is_trivially_relocatable_v<Type>) {
+            Type value(std::forward<Args>(args)...);
+            if (size_ == GetCapacity()) {
+                Relocation(NextCapacity(), RelocationSite::kInsert);
             }
-            *new_pos = value;
-            ++new_pos;
-            std::copy(pos, simpleVector_.Get() + size_, new_pos);
+            Iterator it = simpleVector_.Get() + index;
+            RelocateBytes(it, size_ - index, it + 1);
+            new (it) Type(std::move(value));
+        }
+        else if (size_ == GetCapacity()) {
+            const size_t capacity = NextCapacity();
+            ArrayPtr<Type, Allocator> new_array(capacity, RawMemoryTag{}, simpleVector_.GetAllocator());
+            new (new_array.Get() + index) Type(std::forward<Args>(args)...);
+            try {
+                UninitializedRelocate(simpleVector_.Get(), index, new_array.Get());
+                try {
+                    UninitializedRelocate(simpleVector_.Get() + index, size_ - index, new_array.Get() + index + 1);
+                }
+                catch (...) {
+                    std::destroy_n(new_array.Get(), index);
+                    throw;
+                }
+            }
+            catch (...) {
+                std::destroy_at(new_array.Get() + index);
+                throw;
+            }
+            NoteAllocation(capacity);
+            NoteRelocation(RelocationSite::kInsert, size_);
             simpleVector_.swap(new_array);
-            ++size_;
-            capacity_ = capacity;
-            return --new_pos;
+        }
+        else if (index == size_) {
+            new (simpleVector_.Get() + size_) Type(std::forward<Args>(args)...);
         }
         else {
-            Iterator new_end = simpleVector_.Get() + size_;
-            ++new_end;
-            std::copy_backward(pos, simpleVector_.Get() + size_, new_end);
-            *pos = value;
+            // Временный объект защищает от args, ссылающихся на сдвигаемые элементы
+            Type value(std::forward<Args>(args)...);
+            Iterator last = simpleVector_.Get() + size_;
+            new (last) Type(std::move(*(last - 1)));
+            // Новый хвостовой элемент уже принадлежит вектору: если сдвиг бросит, его уничтожит деструктор
             ++size_;
-            return pos;
+            std::move_backward(simpleVector_.Get() + index, last - 1, last);
+            simpleVector_[index] = std::move(value);
+            return simpleVector_.Get() + index;
         }
-        return pos;
+        ++size_;
+        return simpleVector_.Get() + index;
     }
 
-    Iterator Insert(Iterator pos, Type&& value) {
-        assert(pos >= begin() && pos <= end());
-        size_t capacity{};
-        if (capacity_ == 0) {
-            capacity_ = 1;
-            ++size_;
-            ArrayPtr<Type> simpleVector(1);
-            simpleVector_.swap(simpleVector);
-            simpleVector_[0] = std::move(value);
-            return simpleVector_.Get();
-        }
-        else if (size_ == capacity_) {
-            capacity = 2 * capacity_;
-            ArrayPtr<Type> new_array(capacity);
-            std::move(std::make_move_iterator(simpleVector_.Get()), std::make_move_iterator(pos), new_array.Get());
-            Iterator new_pos = std::move(new_array.Get());
-            Iterator begin_old = std::move(simpleVector_.Get());
-            while (begin_old != pos) {
-                ++begin_old;
-                ++new_pos;
+    // Вставляет count копий value в позицию pos.
+    // Возвращает итератор на первый вставленный элемент
+    Iterator Insert(ConstIterator pos, size_t count, const Type& value) {
+        const size_t index = pos - cbegin();
+        if (count == 0) {
+            return simpleVector_.Get() + index;
+        }
+        // Копия защищает от value, ссылающегося на элемент этого вектора
+        const Type value_copy(value);
+        return InsertN(index, count, FillSource{value_copy});
+    }
+
+    // Вставляет элементы диапазона [first, last) в позицию pos, выполняя не больше
+    // одного перевыделения памяти и одного сдвига хвоста.
+    // Диапазон не должен указывать внутрь этого вектора.
+    // Возвращает итератор на первый вставленный элемент
+    template <std::input_iterator InputIt>
+    Iterator Insert(ConstIterator pos, InputIt first, InputIt last) {
+        const size_t index = pos - cbegin();
+        if constexpr (is_multipass_iterator_v<InputIt>) {
+            return InsertN(index, static_cast<size_t>(std::distance(first, last)), RangeSource<InputIt>{first});
+        }
+        else {
+            // Длина однопроходного диапазона заранее неизвестна: он собирается во временный вектор
+            SimpleVector buffer(GetAllocator());
+            for (; first != last; ++first) {
+                buffer.EmplaceBack(*first);
             }
-            *new_pos = std::move(value);
-            ++new_pos;
-            std::move(std::make_move_iterator(pos), std::make_move_iterator(simpleVector_.Get() + size_), new_pos);
-            simpleVector_.swap(new_array);
-            ++size_;
-            capacity_ = std::move(capacity);
-            return --new_pos;
+            auto moved = std::make_move_iterator(buffer.begin());
+            return InsertN(index, static_cast<size_t>(buffer.end() - buffer.begin()), RangeSource<decltype(moved)>{moved});
+        }
+    }
+
+    Iterator Insert(ConstIterator pos, std::initializer_list<Type> init) {
+        return Insert(pos, init.begin(), init.end());
+    }
+
+    // Добавляет элементы диапазона в конец вектора.
+    // Элементы временного (rvalue) диапазона перемещаются
+    template <std::ranges::input_range Range>
+        requires std::ranges::common_range<Range>
+    void Append(Range&& range) {
+        if constexpr (std::is_lvalue_reference_v<Range>) {
+            Append(std::ranges::begin(range), std::ranges::end(range));
         }
         else {
-            Iterator new_end = std::move(simpleVector_.Get() + size_);
-            ++new_end;
-            std::move_backward(std::make_move_iterator(pos), std::make_move_iterator(simpleVector_.Get() + size_), new_end);
-            *pos = std::move(value);
-            ++size_;
-            return pos;
+            Append(std::make_move_iterator(std::ranges::begin(range)), std::make_move_iterator(std::ranges::end(range)));
         }
-        return pos;
     }
 
-    // "Удаляет" последний элемент вектора. Вектор не должен быть пустым
+    template <std::input_iterator InputIt>
+    void Append(InputIt first, InputIt last) {
+        Insert(cend(), first, last);
+    }
+
+    void Append(std::initializer_list<Type> init) {
+        Insert(cend(), init.begin(), init.end());
+    }
+
+    // Удаляет последний элемент вектора. Вектор не должен быть пустым
     void PopBack() noexcept {
         assert(!IsEmpty());
         --size_;
+        std::destroy_at(simpleVector_.Get() + size_);
     }
 
     // Удаляет элемент вектора в указанной позиции
     Iterator Erase(ConstIterator pos) {
-        assert(pos >= cbegin() && pos <= cend());
-        Iterator it_next = const_cast<Iterator>(pos);
-        ++it_next;
-        std::move(it_next, simpleVector_.Get() + size_, const_cast<Iterator>(pos));
-        --size_;
-        return --it_next;
+        assert(pos >= cbegin() && pos < cend());
+        Iterator it = simpleVector_.Get() + (pos - cbegin());
+        if constexpr (is_trivially_relocatable_v<Type>) {
+            std::destroy_at(it);
+            RelocateBytes(it + 1, simpleVector_.Get() + size_ - (it + 1), it);
+            --size_;
+        }
+        else {
+            std::move(it + 1, simpleVector_.Get() + size_, it);
+            PopBack();
+        }
+        return it;
     }
 
-    // Обменивает значение с другим вектором
+    // Удаляет элементы диапазона [first, last) одним сдвигом хвоста.
+    // Возвращает итератор на элемент, следовавший за удалёнными
+    Iterator Erase(ConstIterator first, ConstIterator last) {
+        assert(cbegin() <= first && first <= last && last <= cend());
+        Iterator it = simpleVector_.Get() + (first - cbegin());
+        const size_t count = last - first;
+        if (count == 0) {
+            return it;
+        }
+        Iterator old_end = simpleVector_.Get() + size_;
+        if constexpr (is_trivially_relocatable_v<Type>) {
+            std::destroy_n(it, count);
+            RelocateBytes(it + count, old_end - (it + count), it);
+        }
+        else {
+            Iterator new_end = std::move(it + count, old_end, it);
+            std::destroy(new_end, old_end);
+        }
+        size_ -= count;
+        return it;
+    }
+
+    // Обменивает значение с другим вектором.
+    // Если аллокатор не распространяется при обмене, аллокаторы векторов должны быть равны
     void swap(SimpleVector& other) noexcept {
         other.simpleVector_.swap(simpleVector_);
         std::swap(other.size_, size_);
-        std::swap(other.capacity_, capacity_);
     }
 
     // Возвращает итератор на начало массива
@@ -359,48 +559,192 @@ public:
     }
 
 private:
-    ArrayPtr<Type>simpleVector_{};
+    using AllocTraits = std::allocator_traits<Allocator>;
+    using Stats = VectorStats<SimpleVector>;
+
+    ArrayPtr<Type, Allocator>simpleVector_{Allocator()};
     size_t size_{};
-    size_t capacity_{};
 
-    void Relocation(size_t new_size) {
-        ArrayPtr<Type> new_array(new_size);
-        std::copy(simpleVector_.Get(), simpleVector_.Get() + size_, new_array.Get());
-        simpleVector_.swap(new_array);
-        capacity_ = new_size;
+    SimpleVector(ArrayPtr<Type, Allocator>&& buffer, size_t size) noexcept
+        : simpleVector_(std::move(buffer))
+        , size_(size) {
+    }
+
+    void CheckSlice(size_t first, size_t last) const {
+        if (first > last || last > size_) {
+            throw std::out_of_range("out_of_range");
+        }
+    }
+
+    // Вместимость, в которую поместятся required элементов
+    size_t GrowCapacity(size_t required) const noexcept {
+        const size_t capacity = GrowthPolicy::NextCapacity(GetCapacity(), required, sizeof(Type));
+        assert(capacity >= required);
+        return capacity;
+    }
+
+    // Вместимость после роста заполненного вектора
+    size_t NextCapacity() const noexcept {
+        return GrowCapacity(size_ + 1);
+    }
+
+    // Источники элементов для InsertN.
+    // Construct конструирует в сырой памяти dest элементы [from, from + count) вставляемой последовательности,
+    // Assign присваивает их живым элементам dest
+    template <typename ForwardIt>
+    struct RangeSource {
+        ForwardIt first;
+
+        void Construct(Type* dest, size_t from, size_t count) const {
+            std::uninitialized_copy_n(std::next(first, from), count, dest);
+        }
+
+        void Assign(Type* dest, size_t from, size_t count) const {
+            std::copy_n(std::next(first, from), count, dest);
+        }
+    };
+
+    struct FillSource {
+        const Type& value;
+
+        void Construct(Type* dest, size_t, size_t count) const {
+            std::uninitialized_fill_n(dest, count, value);
+        }
+
+        void Assign(Type* dest, size_t, size_t count) const {
+            std::fill_n(dest, count, value);
+        }
+    };
+
+    // Вставляет count элементов из source в позицию index: не больше одного перевыделения памяти
+    // и одного сдвига хвоста
+    template <typename Source>
+    Iterator InsertN(size_t index, size_t count, const Source& source) {
+        assert(index <= size_);
+        if (count == 0) {
+            return simpleVector_.Get() + index;
+        }
+        if (size_ + count > GetCapacity()) {
+            const size_t capacity = GrowCapacity(size_ + count);
+            ArrayPtr<Type, Allocator> new_array(capacity, RawMemoryTag{}, simpleVector_.GetAllocator());
+            source.Construct(new_array.Get() + index, 0, count);
+            try {
+                UninitializedRelocate(simpleVector_.Get(), index, new_array.Get());
+                try {
+                    UninitializedRelocate(simpleVector_.Get() + index, size_ - index, new_array.Get() + index + count);
+                }
+                catch (...) {
+                    std::destroy_n(new_array.Get(), index);
+                    throw;
+                }
+            }
+            catch (...) {
+                std::destroy_n(new_array.Get() + index, count);
+                throw;
+            }
+            NoteAllocation(capacity);
+            NoteRelocation(RelocationSite::kInsert, size_);
+            simpleVector_.swap(new_array);
+            size_ += count;
+        }
+        else if constexpr (is_trivially_relocatable_v<Type>) {
+            Iterator pos = simpleVector_.Get() + index;
+            const size_t elems_after = simpleVector_.Get() + size_ - pos;
+            RelocateBytes(pos, elems_after, pos + count);
+            try {
+                source.Construct(pos, 0, count);
+            }
+            catch (...) {
+                RelocateBytes(pos + count, elems_after, pos);
+                throw;
+            }
+            size_ += count;
+        }
+        else {
+            Iterator pos = simpleVector_.Get() + index;
+            Iterator old_end = simpleVector_.Get() + size_;
+            const size_t elems_after = size_ - index;
+            if (elems_after > count) {
+                // Последние count элементов уезжают в сырую память, остальные сдвигаются присваиванием
+                std::uninitialized_move(old_end - count, old_end, old_end);
+                size_ += count;
+                std::move_backward(pos, old_end - count, old_end);
+                source.Assign(pos, 0, count);
+            }
+            else {
+                // Хвост вставки конструируется за концом, весь старый хвост уезжает за него
+                source.Construct(old_end, elems_after, count - elems_after);
+                size_ += count - elems_after;
+                std::uninitialized_move(pos, old_end, pos + count);
+                size_ += elems_after;
+                source.Assign(pos, 0, elems_after);
+            }
+        }
+        return simpleVector_.Get() + index;
+    }
+
+    // Сообщают статистике (vector_stats.h) о выделении памяти и переносе элементов
+    static void NoteAllocation(size_t capacity) noexcept {
+        if (capacity != 0) {
+            Stats::OnAllocate(capacity, capacity * sizeof(Type));
+        }
+    }
+
+    static void NoteRelocation(RelocationSite site, size_t count) noexcept {
+        Stats::OnRelocate(site, count, relocates_by_copy_v<Type>);
+    }
+
+    void Relocation(size_t new_size, RelocationSite site = RelocationSite::kReserve) {
+        if constexpr (is_trivially_relocatable_v<Type>) {
+            simpleVector_.Reallocate(new_size);
+        }
+        else {
+            ArrayPtr<Type, Allocator> new_array(new_size, RawMemoryTag{}, simpleVector_.GetAllocator());
+            UninitializedRelocate(simpleVector_.Get(), size_, new_array.Get());
+            simpleVector_.swap(new_array);
+        }
+        NoteAllocation(new_size);
+        NoteRelocation(site, size_);
     }
 };
 
-template <typename Type>
-inline bool operator==(const SimpleVector<Type>& lhs, const SimpleVector<Type>& rhs) {
-    return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+template <typename Type, typename Allocator, typename GrowthPolicy>
+inline bool operator==(const SimpleVector<Type, Allocator, GrowthPolicy>& lhs, const SimpleVector<Type, Allocator, GrowthPolicy>& rhs) {
+    return lhs.GetSize() == rhs.GetSize() && ParallelEqual(lhs.begin(), rhs.begin(), lhs.GetSize());
 }
 
-template <typename Type>
-inline bool operator!=(const SimpleVector<Type>& lhs, const SimpleVector<Type>& rhs) {
-    return !std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+template <typename Type, typename Allocator, typename GrowthPolicy>
+inline bool operator!=(const SimpleVector<Type, Allocator, GrowthPolicy>& lhs, const SimpleVector<Type, Allocator, GrowthPolicy>& rhs) {
+    return !(lhs == rhs);
 }
 
-template <typename Type>
-inline bool operator<(const SimpleVector<Type>& lhs, const SimpleVector<Type>& rhs) {
-    return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+template <typename Type, typename Allocator, typename GrowthPolicy>
+inline bool operator<(const SimpleVector<Type, Allocator, GrowthPolicy>& lhs, const SimpleVector<Type, Allocator, GrowthPolicy>& rhs) {
+    return ParallelLexicographicalLess(lhs.begin(), lhs.GetSize(), rhs.begin(), rhs.GetSize());
 }
 
-template <typename Type>
-inline bool operator<=(const SimpleVector<Type>& lhs, const SimpleVector<Type>& rhs) {
+template <typename Type, typename Allocator, typename GrowthPolicy>
+inline bool operator<=(const SimpleVector<Type, Allocator, GrowthPolicy>& lhs, const SimpleVector<Type, Allocator, GrowthPolicy>& rhs) {
     return !(lhs > rhs);
 }
 
-template <typename Type>
-inline bool operator>(const SimpleVector<Type>& lhs, const SimpleVector<Type>& rhs) {
-    return std::lexicographical_compare(rhs.begin(), rhs.end(), lhs.begin(), lhs.end());
+template <typename Type, typename Allocator, typename GrowthPolicy>
+inline bool operator>(const SimpleVector<Type, Allocator, GrowthPolicy>& lhs, const SimpleVector<Type, Allocator, GrowthPolicy>& rhs) {
+    return rhs < lhs;
 }
 
-template <typename Type>
-inline bool operator>=(const SimpleVector<Type>& lhs, const SimpleVector<Type>& rhs) {
+template <typename Type, typename Allocator, typename GrowthPolicy>
+inline bool operator>=(const SimpleVector<Type, Allocator, GrowthPolicy>& lhs, const SimpleVector<Type, Allocator, GrowthPolicy>& rhs) {
     return !(lhs < rhs);
 }
 
-ReserveProxyObj Reserve(size_t capacity_to_reserve) {
+// Вектор, берущий память у std::pmr::memory_resource, например у MonotonicArena или SizeClassPool
+template <typename Type>
+using PmrSimpleVector = SimpleVector<Type, std::pmr::polymorphic_allocator<Type>>;
+
+inline ReserveProxyObj Reserve(size_t capacity_to_reserve) {
     return ReserveProxyObj(capacity_to_reserve);
-}
\ No newline at end of file
+}
+
+// Упакованная специализация SimpleVector<bool>
+#include "simple_vector_bool.h"
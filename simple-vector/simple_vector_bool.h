@@ -0,0 +1,706 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "simd_compare.h"
+#include "simple_vector.h"
+
+// Упакованный вектор флагов: SimpleVector<bool> хранит по 64 флага в слове uint64_t.
+// operator[] и итераторы неконстантного вектора возвращают прокси-ссылку на бит, константного — bool.
+// Count, FindFirst, сравнение и поразрядные &=, |=, ^= обрабатывают вектор словами.
+// Биты последнего слова за концом вектора всегда нулевые, поэтому слова можно сравнивать и считать целиком.
+// Память под слова берётся у Allocator (для Align<N> — у AlignedAllocator), перепривязанного к uint64_t;
+// GrowthPolicy выбирает вместимость в словах
+template <typename AllocatorParam, typename GrowthPolicy>
+class SimpleVector<bool, AllocatorParam, GrowthPolicy> {
+public:
+    using Allocator = resolve_allocator_t<bool, AllocatorParam>;
+    using Word = uint64_t;
+    static constexpr size_t kWordBits = 64;
+
+    using AllocatorType = Allocator;
+    using GrowthPolicyType = GrowthPolicy;
+
+    // Прокси-ссылка на один флаг
+    class Reference {
+    public:
+        Reference(Word* word, Word mask) noexcept
+            : word_(word)
+            , mask_(mask) {
+        }
+
+        Reference(const Reference&) noexcept = default;
+
+        operator bool() const noexcept {
+            return (*word_ & mask_) != 0;
+        }
+
+        Reference& operator=(bool value) noexcept {
+            *word_ = value ? (*word_ | mask_) : (*word_ & ~mask_);
+            return *this;
+        }
+
+        // Присваивание копирует значение флага, а не саму ссылку
+        Reference& operator=(const Reference& other) noexcept {
+            return *this = static_cast<bool>(other);
+        }
+
+        void Flip() noexcept {
+            *word_ ^= mask_;
+        }
+
+        friend void swap(Reference lhs, Reference rhs) noexcept {
+            const bool value = lhs;
+            lhs = static_cast<bool>(rhs);
+            rhs = value;
+        }
+
+    private:
+        Word* word_;
+        Word mask_;
+    };
+
+    template <bool Const>
+    class BitIterator {
+    public:
+        using WordPointer = std::conditional_t<Const, const Word*, Word*>;
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = bool;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::conditional_t<Const, bool, Reference>;
+        using pointer = void;
+
+        BitIterator() noexcept = default;
+
+        BitIterator(WordPointer words, size_t index) noexcept
+            : words_(words)
+            , index_(index) {
+        }
+
+        // Неконстантный итератор неявно приводится к константному
+        operator BitIterator<true>() const noexcept {
+            return BitIterator<true>(words_, index_);
+        }
+
+        size_t GetIndex() const noexcept {
+            return index_;
+        }
+
+        reference operator*() const noexcept {
+            const Word mask = Word{1} << (index_ % kWordBits);
+            if constexpr (Const) {
+                return (words_[index_ / kWordBits] & mask) != 0;
+            }
+            else {
+                return Reference(words_ + index_ / kWordBits, mask);
+            }
+        }
+
+        reference operator[](difference_type offset) const noexcept {
+            return *(*this + offset);
+        }
+
+        BitIterator& operator++() noexcept {
+            ++index_;
+            return *this;
+        }
+
+        BitIterator operator++(int) noexcept {
+            BitIterator copy = *this;
+            ++index_;
+            return copy;
+        }
+
+        BitIterator& operator--() noexcept {
+            --index_;
+            return *this;
+        }
+
+        BitIterator operator--(int) noexcept {
+            BitIterator copy = *this;
+            --index_;
+            return copy;
+        }
+
+        BitIterator& operator+=(difference_type offset) noexcept {
+            index_ += offset;
+            return *this;
+        }
+
+        BitIterator& operator-=(difference_type offset) noexcept {
+            index_ -= offset;
+            return *this;
+        }
+
+        friend BitIterator operator+(BitIterator it, difference_type offset) noexcept {
+            return it += offset;
+        }
+
+        friend BitIterator operator+(difference_type offset, BitIterator it) noexcept {
+            return it += offset;
+        }
+
+        friend BitIterator operator-(BitIterator it, difference_type offset) noexcept {
+            return it -= offset;
+        }
+
+        friend difference_type operator-(const BitIterator& lhs, const BitIterator& rhs) noexcept {
+            return static_cast<difference_type>(lhs.index_) - static_cast<difference_type>(rhs.index_);
+        }
+
+        friend bool operator==(const BitIterator& lhs, const BitIterator& rhs) noexcept {
+            return lhs.index_ == rhs.index_;
+        }
+
+        friend auto operator<=>(const BitIterator& lhs, const BitIterator& rhs) noexcept {
+            return lhs.index_ <=> rhs.index_;
+        }
+
+    private:
+        WordPointer words_ = nullptr;
+        size_t index_ = 0;
+    };
+
+    using Iterator = BitIterator<false>;
+    using ConstIterator = BitIterator<true>;
+
+    SimpleVector() noexcept = default;
+
+    explicit SimpleVector(const Allocator& alloc) noexcept
+        : words_(WordAllocator(alloc)) {
+    }
+
+    // Создаёт вектор из size сброшенных флагов
+    explicit SimpleVector(size_t size, const Allocator& alloc = Allocator())
+        : SimpleVector(size, false, alloc) {
+    }
+
+    SimpleVector(size_t size, bool value, const Allocator& alloc = Allocator())
+        : words_(WordsFor(size), RawMemoryTag{}, WordAllocator(alloc)) {
+        capacity_ = WordsFor(size);
+        size_ = size;
+        NoteAllocation(capacity_);
+        std::fill_n(words_.Get(), capacity_, value ? ~Word{0} : Word{0});
+        ClearTail();
+    }
+
+    SimpleVector(std::initializer_list<bool> init, const Allocator& alloc = Allocator())
+        : SimpleVector(init.size(), false, alloc) {
+        size_t index = 0;
+        for (bool value : init) {
+            SetBit(index++, value);
+        }
+    }
+
+    SimpleVector(ReserveProxyObj t, const Allocator& alloc = Allocator())
+        : words_(WordAllocator(alloc)) {
+        Reserve(t.capacity_);
+    }
+
+    SimpleVector(const SimpleVector& other)
+        : SimpleVector(other, AllocTraits::select_on_container_copy_construction(other.words_.GetAllocator())) {
+    }
+
+    SimpleVector(const SimpleVector& other, const Allocator& alloc)
+        : words_(WordsFor(other.size_), RawMemoryTag{}, WordAllocator(alloc)) {
+        capacity_ = WordsFor(other.size_);
+        size_ = other.size_;
+        NoteAllocation(capacity_);
+        if (capacity_ != 0) {
+            std::memcpy(words_.Get(), other.words_.Get(), capacity_ * sizeof(Word));
+        }
+    }
+
+    SimpleVector(SimpleVector&& other) noexcept
+        : words_(std::move(other.words_))
+        , size_(std::exchange(other.size_, 0))
+        , capacity_(std::exchange(other.capacity_, 0)) {
+    }
+
+    SimpleVector& operator=(const SimpleVector& rhs) {
+        if (this != &rhs) {
+            auto rhs_copy = AllocTraits::propagate_on_container_copy_assignment::value
+                ? SimpleVector(rhs, rhs.GetAllocator())
+                : SimpleVector(rhs, GetAllocator());
+            swap(rhs_copy);
+        }
+        return *this;
+    }
+
+    SimpleVector& operator=(SimpleVector&& rhs) noexcept(AllocTraits::propagate_on_container_move_assignment::value
+        || AllocTraits::is_always_equal::value) {
+        if (this != &rhs) {
+            if (AllocTraits::propagate_on_container_move_assignment::value || GetAllocator() == rhs.GetAllocator()) {
+                words_ = std::move(rhs.words_);
+                size_ = std::exchange(rhs.size_, 0);
+                capacity_ = std::exchange(rhs.capacity_, 0);
+            }
+            else {
+                // Память rhs принадлежит другому аллокатору: слова копируются
+                SimpleVector rhs_copy(rhs, GetAllocator());
+                rhs.Clear();
+                swap(rhs_copy);
+            }
+        }
+        return *this;
+    }
+
+    ~SimpleVector() {
+        Stats::OnDestroy(size_);
+    }
+
+    Allocator GetAllocator() const noexcept {
+        return Allocator(words_.GetAllocator());
+    }
+
+    // Выделяет память под new_capacity флагов
+    void Reserve(size_t new_capacity) {
+        if (WordsFor(new_capacity) > capacity_) {
+            Relocation(WordsFor(new_capacity));
+        }
+    }
+
+    void ShrinkToFit() {
+        if (capacity_ > WordsFor(size_)) {
+            Relocation(WordsFor(size_));
+        }
+    }
+
+    size_t GetSize() const noexcept {
+        return size_;
+    }
+
+    // Вместимость во флагах, всегда кратна 64
+    size_t GetCapacity() const noexcept {
+        return capacity_ * kWordBits;
+    }
+
+    bool IsEmpty() const noexcept {
+        return size_ == 0;
+    }
+
+    // Слова с флагами; флаг i — бит i % 64 слова i / 64, биты за концом вектора нулевые
+    std::span<const Word> GetWords() const noexcept {
+        return {words_.Get(), WordsFor(size_)};
+    }
+
+    Reference operator[](size_t index) noexcept {
+        assert(index < size_);
+        return MakeReference(index);
+    }
+
+    bool operator[](size_t index) const noexcept {
+        assert(index < size_);
+        return GetBit(index);
+    }
+
+    // Выбрасывает исключение std::out_of_range, если index >= size
+    Reference At(size_t index) {
+        if (index >= size_) {
+            throw std::out_of_range("out_of_range");
+        }
+        return MakeReference(index);
+    }
+
+    bool At(size_t index) const {
+        if (index >= size_) {
+            throw std::out_of_range("out_of_range");
+        }
+        return GetBit(index);
+    }
+
+    void Clear() noexcept {
+        size_ = 0;
+    }
+
+    // Изменяет размер; новые флаги получают значение value
+    void Resize(size_t new_size, bool value = false) {
+        if (new_size > size_) {
+            const size_t old_size = size_;
+            Grow(new_size, RelocationSite::kReserve);
+            FillBits(old_size, new_size - old_size, value);
+        }
+        else {
+            size_ = new_size;
+            ClearTail();
+        }
+    }
+
+    void PushBack(bool value) {
+        EmplaceBack(value);
+    }
+
+    Reference EmplaceBack(bool value = false) {
+        Grow(size_ + 1, RelocationSite::kPushBack);
+        SetBit(size_ - 1, value);
+        return MakeReference(size_ - 1);
+    }
+
+    void PopBack() noexcept {
+        assert(!IsEmpty());
+        --size_;
+        SetBit(size_, false);
+    }
+
+    Iterator Insert(ConstIterator pos, bool value) {
+        return Insert(pos, 1, value);
+    }
+
+    Iterator Emplace(ConstIterator pos, bool value = false) {
+        return Insert(pos, 1, value);
+    }
+
+    // Вставляет count флагов value: хвост сдвигается словами
+    Iterator Insert(ConstIterator pos, size_t count, bool value) {
+        const size_t index = pos.GetIndex();
+        OpenGap(index, count);
+        FillBits(index, count, value);
+        return Iterator(words_.Get(), index);
+    }
+
+    // Диапазон не должен указывать внутрь этого вектора
+    template <std::input_iterator InputIt>
+    Iterator Insert(ConstIterator pos, InputIt first, InputIt last) {
+        const size_t index = pos.GetIndex();
+        if constexpr (std::forward_iterator<InputIt>) {
+            const size_t count = static_cast<size_t>(std::distance(first, last));
+            OpenGap(index, count);
+            for (size_t i = index; first != last; ++first, ++i) {
+                SetBit(i, static_cast<bool>(*first));
+            }
+            return Iterator(words_.Get(), index);
+        }
+        else {
+            SimpleVector buffer(GetAllocator());
+            for (; first != last; ++first) {
+                buffer.PushBack(static_cast<bool>(*first));
+            }
+            return Insert(pos, buffer.cbegin(), buffer.cend());
+        }
+    }
+
+    Iterator Insert(ConstIterator pos, std::initializer_list<bool> init) {
+        return Insert(pos, init.begin(), init.end());
+    }
+
+    template <std::ranges::input_range Range>
+        requires std::ranges::common_range<Range>
+    void Append(Range&& range) {
+        Append(std::ranges::begin(range), std::ranges::end(range));
+    }
+
+    template <std::input_iterator InputIt>
+    void Append(InputIt first, InputIt last) {
+        Insert(cend(), first, last);
+    }
+
+    void Append(std::initializer_list<bool> init) {
+        Insert(cend(), init.begin(), init.end());
+    }
+
+    Iterator Erase(ConstIterator pos) {
+        return Erase(pos, pos + 1);
+    }
+
+    // Удаляет флаги [first, last): хвост сдвигается словами
+    Iterator Erase(ConstIterator first, ConstIterator last) {
+        assert(cbegin() <= first && first <= last && last <= cend());
+        const size_t from = first.GetIndex();
+        const size_t to = last.GetIndex();
+        MoveBits(to, from, size_ - to);
+        size_ -= to - from;
+        ClearTail();
+        return Iterator(words_.Get(), from);
+    }
+
+    // Число установленных флагов
+    size_t Count() const noexcept {
+        size_t count = 0;
+        for (Word word : GetWords()) {
+            count += std::popcount(word);
+        }
+        return count;
+    }
+
+    // Индекс первого установленного флага или GetSize(), если таких нет
+    size_t FindFirst() const noexcept {
+        return FindNext(0);
+    }
+
+    // Индекс первого установленного флага, не меньший from, или GetSize()
+    size_t FindNext(size_t from) const noexcept {
+        if (from >= size_) {
+            return size_;
+        }
+        const size_t words = WordsFor(size_);
+        size_t index = from / kWordBits;
+        Word word = words_[index] & (~Word{0} << (from % kWordBits));
+        while (word == 0) {
+            if (++index == words) {
+                return size_;
+            }
+            word = words_[index];
+        }
+        return index * kWordBits + std::countr_zero(word);
+    }
+
+    // Инвертирует все флаги
+    void Flip() noexcept {
+        for (size_t i = 0; i < WordsFor(size_); ++i) {
+            words_[i] = ~words_[i];
+        }
+        ClearTail();
+    }
+
+    // Поразрядные операции над векторами одного размера.
+    // Выбрасывают исключение std::invalid_argument, если размеры различаются
+    SimpleVector& operator&=(const SimpleVector& rhs) {
+        return Combine(rhs, [](Word lhs, Word rhs) {
+            return lhs & rhs;
+        });
+    }
+
+    SimpleVector& operator|=(const SimpleVector& rhs) {
+        return Combine(rhs, [](Word lhs, Word rhs) {
+            return lhs | rhs;
+        });
+    }
+
+    SimpleVector& operator^=(const SimpleVector& rhs) {
+        return Combine(rhs, [](Word lhs, Word rhs) {
+            return lhs ^ rhs;
+        });
+    }
+
+    void swap(SimpleVector& other) noexcept {
+        words_.swap(other.words_);
+        std::swap(size_, other.size_);
+        std::swap(capacity_, other.capacity_);
+    }
+
+    Iterator begin() noexcept {
+        return Iterator(words_.Get(), 0);
+    }
+
+    Iterator end() noexcept {
+        return Iterator(words_.Get(), size_);
+    }
+
+    ConstIterator begin() const noexcept {
+        return ConstIterator(words_.Get(), 0);
+    }
+
+    ConstIterator end() const noexcept {
+        return ConstIterator(words_.Get(), size_);
+    }
+
+    ConstIterator cbegin() const noexcept {
+        return begin();
+    }
+
+    ConstIterator cend() const noexcept {
+        return end();
+    }
+
+private:
+    using WordAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Word>;
+    using AllocTraits = std::allocator_traits<WordAllocator>;
+    using Stats = VectorStats<SimpleVector>;
+
+    ArrayPtr<Word, WordAllocator> words_{WordAllocator()};
+    size_t size_{};
+    // Вместимость в словах
+    size_t capacity_{};
+
+    static size_t WordsFor(size_t bits) noexcept {
+        return (bits + kWordBits - 1) / kWordBits;
+    }
+
+    // Маска младших count битов, count от 1 до 64
+    static Word LowMask(size_t count) noexcept {
+        return count == kWordBits ? ~Word{0} : (Word{1} << count) - 1;
+    }
+
+    bool GetBit(size_t index) const noexcept {
+        return (words_[index / kWordBits] >> (index % kWordBits)) & 1;
+    }
+
+    void SetBit(size_t index, bool value) noexcept {
+        MakeReference(index) = value;
+    }
+
+    Reference MakeReference(size_t index) noexcept {
+        return Reference(words_.Get() + index / kWordBits, Word{1} << (index % kWordBits));
+    }
+
+    // Обнуляет биты последнего слова за концом вектора
+    void ClearTail() noexcept {
+        if (size_ % kWordBits != 0) {
+            words_[size_ / kWordBits] &= LowMask(size_ % kWordBits);
+        }
+    }
+
+    // Читает count битов (от 1 до 64), начиная с бита pos; они могут занимать два слова
+    Word GetBits(size_t pos, size_t count) const noexcept {
+        const size_t index = pos / kWordBits;
+        const size_t offset = pos % kWordBits;
+        Word bits = words_[index] >> offset;
+        if (offset != 0 && offset + count > kWordBits) {
+            bits |= words_[index + 1] << (kWordBits - offset);
+        }
+        return bits & LowMask(count);
+    }
+
+    // Записывает младшие count битов (от 1 до 64) значения bits, начиная с бита pos
+    void SetBits(size_t pos, size_t count, Word bits) noexcept {
+        const size_t index = pos / kWordBits;
+        const size_t offset = pos % kWordBits;
+        const Word mask = LowMask(count);
+        bits &= mask;
+        words_[index] = (words_[index] & ~(mask << offset)) | (bits << offset);
+        if (offset != 0 && offset + count > kWordBits) {
+            const size_t shift = kWordBits - offset;
+            words_[index + 1] = (words_[index + 1] & ~(mask >> shift)) | (bits >> shift);
+        }
+    }
+
+    // Переносит count битов из позиции from в позицию to кусками по слову, как memmove:
+    // при переносе вперёд куски копируются с конца, чтобы не затереть ещё не прочитанные
+    void MoveBits(size_t from, size_t to, size_t count) noexcept {
+        if (to < from) {
+            for (size_t done = 0; done < count; done += kWordBits) {
+                const size_t chunk = std::min(kWordBits, count - done);
+                SetBits(to + done, chunk, GetBits(from + done, chunk));
+            }
+        }
+        else if (to > from) {
+            for (size_t left = count; left > 0;) {
+                const size_t chunk = std::min(kWordBits, left);
+                left -= chunk;
+                SetBits(to + left, chunk, GetBits(from + left, chunk));
+            }
+        }
+    }
+
+    void FillBits(size_t pos, size_t count, bool value) noexcept {
+        const Word bits = value ? ~Word{0} : Word{0};
+        for (size_t done = 0; done < count; done += kWordBits) {
+            SetBits(pos + done, std::min(kWordBits, count - done), bits);
+        }
+    }
+
+    // Увеличивает размер до new_size; новые слова обнуляются, значения новых флагов не определены
+    void Grow(size_t new_size, RelocationSite site) {
+        const size_t words = WordsFor(new_size);
+        if (words > capacity_) {
+            const size_t capacity = GrowthPolicy::NextCapacity(capacity_, words, sizeof(Word));
+            assert(capacity >= words);
+            Relocation(capacity, site);
+        }
+        std::fill(words_.Get() + WordsFor(size_), words_.Get() + words, Word{0});
+        size_ = new_size;
+    }
+
+    // Освобождает count флагов в позиции index, сдвигая хвост
+    void OpenGap(size_t index, size_t count) {
+        assert(index <= size_);
+        const size_t old_size = size_;
+        Grow(size_ + count, RelocationSite::kInsert);
+        MoveBits(index, index + count, old_size - index);
+    }
+
+    template <typename Operation>
+    SimpleVector& Combine(const SimpleVector& rhs, const Operation& operation) {
+        if (size_ != rhs.size_) {
+            throw std::invalid_argument("bit vectors differ in size");
+        }
+        Word* words = words_.Get();
+        const Word* other = rhs.words_.Get();
+        for (size_t i = 0; i < WordsFor(size_); ++i) {
+            words[i] = operation(words[i], other[i]);
+        }
+        return *this;
+    }
+
+    static void NoteAllocation(size_t words) noexcept {
+        if (words != 0) {
+            Stats::OnAllocate(words * kWordBits, words * sizeof(Word));
+        }
+    }
+
+    void Relocation(size_t new_words, RelocationSite site = RelocationSite::kReserve) {
+        words_.Reallocate(new_words);
+        NoteAllocation(new_words);
+        Stats::OnRelocate(site, size_, false);
+        capacity_ = new_words;
+    }
+};
+
+// Сравнение упакованных векторов идёт словами; более специализированные шаблоны
+// выбираются вместо общих, а остальные операторы сравнения выражены через эти два
+template <typename Allocator, typename GrowthPolicy>
+bool operator==(const SimpleVector<bool, Allocator, GrowthPolicy>& lhs, const SimpleVector<bool, Allocator, GrowthPolicy>& rhs) {
+    return lhs.GetSize() == rhs.GetSize() && ParallelEqual(lhs.GetWords().data(), rhs.GetWords().data(), lhs.GetWords().size());
+}
+
+template <typename Allocator, typename GrowthPolicy>
+bool operator<(const SimpleVector<bool, Allocator, GrowthPolicy>& lhs, const SimpleVector<bool, Allocator, GrowthPolicy>& rhs) {
+    using Word = typename SimpleVector<bool, Allocator, GrowthPolicy>::Word;
+    constexpr size_t kWordBits = SimpleVector<bool, Allocator, GrowthPolicy>::kWordBits;
+    const size_t common = std::min(lhs.GetSize(), rhs.GetSize());
+    const Word* lhs_words = lhs.GetWords().data();
+    const Word* rhs_words = rhs.GetWords().data();
+    const size_t full_words = common / kWordBits;
+    size_t index = FirstUnequal(lhs_words, rhs_words, full_words);
+    Word diff = 0;
+    if (index < full_words) {
+        diff = lhs_words[index] ^ rhs_words[index];
+    }
+    else if (common % kWordBits != 0) {
+        diff = (lhs_words[index] ^ rhs_words[index]) & ((Word{1} << (common % kWordBits)) - 1);
+    }
+    if (diff == 0) {
+        return lhs.GetSize() < rhs.GetSize();
+    }
+    // Первый различающийся флаг — младший бит разности; lhs меньше, если у него этот флаг сброшен
+    return ((rhs_words[index] >> std::countr_zero(diff)) & 1) != 0;
+}
+
+template <typename Allocator, typename GrowthPolicy>
+SimpleVector<bool, Allocator, GrowthPolicy> operator&(SimpleVector<bool, Allocator, GrowthPolicy> lhs,
+    const SimpleVector<bool, Allocator, GrowthPolicy>& rhs) {
+    lhs &= rhs;
+    return lhs;
+}
+
+template <typename Allocator, typename GrowthPolicy>
+SimpleVector<bool, Allocator, GrowthPolicy> operator|(SimpleVector<bool, Allocator, GrowthPolicy> lhs,
+    const SimpleVector<bool, Allocator, GrowthPolicy>& rhs) {
+    lhs |= rhs;
+    return lhs;
+}
+
+template <typename Allocator, typename GrowthPolicy>
+SimpleVector<bool, Allocator, GrowthPolicy> operator^(SimpleVector<bool, Allocator, GrowthPolicy> lhs,
+    const SimpleVector<bool, Allocator, GrowthPolicy>& rhs) {
+    lhs ^= rhs;
+    return lhs;
+}
+
+template <typename Allocator, typename GrowthPolicy>
+SimpleVector<bool, Allocator, GrowthPolicy> operator~(SimpleVector<bool, Allocator, GrowthPolicy> vector) {
+    vector.Flip();
+    return vector;
+}
@@ -0,0 +1,396 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <initializer_list>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "allocator.h"
+#include "array_ptr.h"
+#include "parallel.h"
+#include "relocation.h"
+#include "simple_vector.h"
+
+// Вектор с встроенным буфером на N элементов.
+// Пока элементов не больше N, они хранятся прямо в объекте и куча не используется;
+// при переполнении элементы переезжают в ArrayPtr из кучи, и дальше вектор растёт как SimpleVector
+template <typename Type, size_t N, typename Allocator = MallocAllocator<Type>>
+class SmallSimpleVector {
+    static_assert(N > 0, "inline capacity must be positive");
+
+public:
+    using Iterator = Type*;
+    using ConstIterator = const Type*;
+    using AllocatorType = Allocator;
+
+    SmallSimpleVector() noexcept = default;
+
+    // Создаёт пустой вектор, берущий память кучи у аллокатора alloc
+    explicit SmallSimpleVector(const Allocator& alloc) noexcept :heap_(alloc) {
+    }
+
+    // Создаёт вектор из size элементов, инициализированных значением по умолчанию
+    explicit SmallSimpleVector(size_t size, const Allocator& alloc = Allocator()) :heap_(alloc) {
+        Reserve(size);
+        std::uninitialized_value_construct_n(Data(), size);
+        size_ = size;
+    }
+
+    // Создаёт вектор из size элементов, инициализированных значением value
+    SmallSimpleVector(size_t size, const Type& value, const Allocator& alloc = Allocator()) :heap_(alloc) {
+        Reserve(size);
+        std::uninitialized_fill_n(Data(), size, value);
+        size_ = size;
+    }
+
+    // Создаёт вектор из std::initializer_list
+    SmallSimpleVector(std::initializer_list<Type> init, const Allocator& alloc = Allocator()) :heap_(alloc) {
+        Reserve(init.size());
+        std::uninitialized_copy(init.begin(), init.end(), Data());
+        size_ = init.size();
+    }
+
+    SmallSimpleVector(ReserveProxyObj t, const Allocator& alloc = Allocator()) :heap_(alloc) {
+        Reserve(t.capacity_);
+    }
+
+    SmallSimpleVector(const SmallSimpleVector& other)
+        :heap_(std::allocator_traits<Allocator>::select_on_container_copy_construction(other.heap_.GetAllocator())) {
+        Reserve(other.size_);
+        std::uninitialized_copy(other.begin(), other.end(), Data());
+        size_ = other.size_;
+    }
+
+    // Забирает буфер кучи other целиком, а встроенные элементы переносит поштучно
+    SmallSimpleVector(SmallSimpleVector&& other) noexcept(std::is_nothrow_move_constructible_v<Type>)
+        :heap_(other.heap_.GetAllocator()) {
+        if (other.IsInline()) {
+            UninitializedRelocate(other.InlineData(), other.size_, InlineData());
+        }
+        else {
+            heap_.swap(other.heap_);
+            capacity_ = std::exchange(other.capacity_, N);
+        }
+        size_ = std::exchange(other.size_, 0);
+    }
+
+    SmallSimpleVector& operator=(const SmallSimpleVector& rhs) {
+        if (this != &rhs) {
+            // Copy-and-swap: при исключении текущий объект не меняется
+            auto rhs_copy(rhs);
+            swap(rhs_copy);
+        }
+        return *this;
+    }
+
+    SmallSimpleVector& operator=(SmallSimpleVector&& rhs) noexcept(std::is_nothrow_move_constructible_v<Type>) {
+        if (this != &rhs) {
+            SmallSimpleVector rhs_moved(std::move(rhs));
+            swap(rhs_moved);
+        }
+        return *this;
+    }
+
+    ~SmallSimpleVector() {
+        std::destroy_n(Data(), size_);
+    }
+
+    // Выделяет память под new_capacity элементов, не конструируя новых
+    void Reserve(size_t new_capacity) {
+        if (new_capacity > capacity_) {
+            Relocation(new_capacity);
+        }
+    }
+
+    // Возвращает количество элементов в массиве
+    size_t GetSize() const noexcept {
+        return size_;
+    }
+
+    // Возвращает вместимость массива; она не меньше N
+    size_t GetCapacity() const noexcept {
+        return capacity_;
+    }
+
+    // Сообщает, пустой ли массив
+    bool IsEmpty() const noexcept {
+        return size_ == 0;
+    }
+
+    // Сообщает, лежат ли элементы во встроенном буфере
+    bool IsInline() const noexcept {
+        return !heap_;
+    }
+
+    // Возвращает ссылку на элемент с индексом index
+    Type& operator[](size_t index) noexcept {
+        assert(index < size_);
+        return Data()[index];
+    }
+
+    // Возвращает константную ссылку на элемент с индексом index
+    const Type& operator[](size_t index) const noexcept {
+        assert(index < size_);
+        return Data()[index];
+    }
+
+    // Возвращает ссылку на элемент с индексом index
+    // Выбрасывает исключение std::out_of_range, если index >= size
+    Type& At(size_t index) {
+        if (index >= size_) {
+            throw std::out_of_range("out_of_range");
+        }
+        return Data()[index];
+    }
+
+    // Возвращает константную ссылку на элемент с индексом index
+    // Выбрасывает исключение std::out_of_range, если index >= size
+    const Type& At(size_t index) const {
+        if (index >= size_) {
+            throw std::out_of_range("out_of_range");
+        }
+        return Data()[index];
+    }
+
+    // Разрушает элементы и обнуляет размер массива, не изменяя его вместимость
+    void Clear() noexcept {
+        std::destroy_n(Data(), size_);
+        size_ = 0;
+    }
+
+    // Изменяет размер массива.
+    // При увеличении размера новые элементы получают значение по умолчанию для типа Type,
+    // при уменьшении лишние элементы разрушаются
+    void Resize(size_t new_size) {
+        if (new_size > capacity_) {
+            Relocation(std::max(new_size, 2 * capacity_));
+        }
+        if (new_size > size_) {
+            std::uninitialized_value_construct(Data() + size_, Data() + new_size);
+        }
+        else {
+            std::destroy(Data() + new_size, Data() + size_);
+        }
+        size_ = new_size;
+    }
+
+    // Добавляет элемент в конец вектора
+    // При нехватке места увеличивает вдвое вместимость вектора
+    void PushBack(const Type& item) {
+        EmplaceBack(item);
+    }
+
+    void PushBack(Type&& item) {
+        EmplaceBack(std::move(item));
+    }
+
+    // Конструирует элемент из аргументов args в конце вектора
+    template <typename... Args>
+    Type& EmplaceBack(Args&&... args) {
+        return *Emplace(cend(), std::forward<Args>(args)...);
+    }
+
+    // Вставляет значение value в позицию pos.
+    // Возвращает итератор на вставленное значение
+    Iterator Insert(ConstIterator pos, const Type& value) {
+        return Emplace(pos, value);
+    }
+
+    Iterator Insert(ConstIterator pos, Type&& value) {
+        return Emplace(pos, std::move(value));
+    }
+
+    // Конструирует элемент из аргументов args в позиции pos.
+    // Возвращает итератор на вставленное значение
+    template <typename... Args>
+    Iterator Emplace(ConstIterator pos, Args&&... args) {
+        assert(pos >= cbegin() && pos <= cend());
+        const size_t index = pos - cbegin();
+        if (size_ == capacity_) {
+            const size_t capacity = 2 * capacity_;
+            ArrayPtr<Type, Allocator> new_array(capacity, RawMemoryTag{}, heap_.GetAllocator());
+            // Новый элемент создаётся до переноса старых: args могут ссылаться на элемент этого вектора
+            new (new_array.Get() + index) Type(std::forward<Args>(args)...);
+            try {
+                UninitializedRelocate(Data(), index, new_array.Get());
+                try {
+                    UninitializedRelocate(Data() + index, size_ - index, new_array.Get() + index + 1);
+                }
+                catch (...) {
+                    std::destroy_n(new_array.Get(), index);
+                    throw;
+                }
+            }
+            catch (...) {
+                std::destroy_at(new_array.Get() + index);
+                throw;
+            }
+            heap_.swap(new_array);
+            capacity_ = capacity;
+        }
+        else if (index == size_) {
+            new (Data() + size_) Type(std::forward<Args>(args)...);
+        }
+        else if constexpr (is_trivially_relocatable_v<Type>) {
+            Type value(std::forward<Args>(args)...);
+            Iterator it = Data() + index;
+            RelocateBytes(it, size_ - index, it + 1);
+            new (it) Type(std::move(value));
+        }
+        else {
+            // Временный объект защищает от args, ссылающихся на сдвигаемые элементы
+            Type value(std::forward<Args>(args)...);
+            Iterator last = Data() + size_;
+            new (last) Type(std::move(*(last - 1)));
+            // Новый хвостовой элемент уже принадлежит вектору: если сдвиг бросит, его уничтожит деструктор
+            ++size_;
+            std::move_backward(Data() + index, last - 1, last);
+            Data()[index] = std::move(value);
+            return Data() + index;
+        }
+        ++size_;
+        return Data() + index;
+    }
+
+    // Удаляет последний элемент вектора. Вектор не должен быть пустым
+    void PopBack() noexcept {
+        assert(!IsEmpty());
+        --size_;
+        std::destroy_at(Data() + size_);
+    }
+
+    // Удаляет элемент вектора в указанной позиции
+    Iterator Erase(ConstIterator pos) {
+        assert(pos >= cbegin() && pos < cend());
+        Iterator it = Data() + (pos - cbegin());
+        if constexpr (is_trivially_relocatable_v<Type>) {
+            std::destroy_at(it);
+            RelocateBytes(it + 1, Data() + size_ - (it + 1), it);
+            --size_;
+        }
+        else {
+            std::move(it + 1, Data() + size_, it);
+            PopBack();
+        }
+        return it;
+    }
+
+    // Обменивает значение с другим вектором.
+    // Буферы кучи меняются местами, встроенные элементы переносятся поштучно
+    void swap(SmallSimpleVector& other) noexcept(std::is_nothrow_move_constructible_v<Type> && std::is_nothrow_swappable_v<Type>) {
+        if (!IsInline() && !other.IsInline()) {
+            heap_.swap(other.heap_);
+        }
+        else if (IsInline() && other.IsInline()) {
+            SmallSimpleVector& shorter = size_ < other.size_ ? *this : other;
+            SmallSimpleVector& longer = size_ < other.size_ ? other : *this;
+            std::swap_ranges(shorter.InlineData(), shorter.InlineData() + shorter.size_, longer.InlineData());
+            UninitializedRelocate(longer.InlineData() + shorter.size_, longer.size_ - shorter.size_,
+                shorter.InlineData() + shorter.size_);
+        }
+        else {
+            SmallSimpleVector& inline_vector = IsInline() ? *this : other;
+            SmallSimpleVector& heap_vector = IsInline() ? other : *this;
+            // Встроенный буфер вектора из кучи свободен: элементы переезжают туда
+            UninitializedRelocate(inline_vector.InlineData(), inline_vector.size_, heap_vector.InlineData());
+            inline_vector.heap_.swap(heap_vector.heap_);
+        }
+        std::swap(size_, other.size_);
+        std::swap(capacity_, other.capacity_);
+    }
+
+    // Возвращает итератор на начало массива
+    Iterator begin() noexcept {
+        return Data();
+    }
+
+    // Возвращает итератор на элемент, следующий за последним
+    Iterator end() noexcept {
+        return Data() + size_;
+    }
+
+    // Возвращает константный итератор на начало массива
+    ConstIterator begin() const noexcept {
+        return Data();
+    }
+
+    // Возвращает константный итератор на элемент, следующий за последним
+    ConstIterator end() const noexcept {
+        return Data() + size_;
+    }
+
+    // Возвращает константный итератор на начало массива
+    ConstIterator cbegin() const noexcept {
+        return Data();
+    }
+
+    // Возвращает константный итератор на элемент, следующий за последним
+    ConstIterator cend() const noexcept {
+        return Data() + size_;
+    }
+
+private:
+    alignas(Type) std::byte inline_storage_[N * sizeof(Type)];
+    ArrayPtr<Type, Allocator> heap_{Allocator()};
+    size_t size_ = 0;
+    size_t capacity_ = N;
+
+    Type* InlineData() noexcept {
+        return std::launder(reinterpret_cast<Type*>(inline_storage_));
+    }
+
+    const Type* InlineData() const noexcept {
+        return std::launder(reinterpret_cast<const Type*>(inline_storage_));
+    }
+
+    Type* Data() noexcept {
+        return heap_ ? heap_.Get() : InlineData();
+    }
+
+    const Type* Data() const noexcept {
+        return heap_ ? heap_.Get() : InlineData();
+    }
+
+    // Переносит элементы в буфер кучи на new_capacity элементов
+    void Relocation(size_t new_capacity) {
+        ArrayPtr<Type, Allocator> new_array(new_capacity, RawMemoryTag{}, heap_.GetAllocator());
+        UninitializedRelocate(Data(), size_, new_array.Get());
+        heap_.swap(new_array);
+        capacity_ = new_capacity;
+    }
+};
+
+template <typename Type, size_t N, typename Allocator>
+inline bool operator==(const SmallSimpleVector<Type, N, Allocator>& lhs, const SmallSimpleVector<Type, N, Allocator>& rhs) {
+    return lhs.GetSize() == rhs.GetSize() && ParallelEqual(lhs.begin(), rhs.begin(), lhs.GetSize());
+}
+
+template <typename Type, size_t N, typename Allocator>
+inline bool operator!=(const SmallSimpleVector<Type, N, Allocator>& lhs, const SmallSimpleVector<Type, N, Allocator>& rhs) {
+    return !(lhs == rhs);
+}
+
+template <typename Type, size_t N, typename Allocator>
+inline bool operator<(const SmallSimpleVector<Type, N, Allocator>& lhs, const SmallSimpleVector<Type, N, Allocator>& rhs) {
+    return ParallelLexicographicalLess(lhs.begin(), lhs.GetSize(), rhs.begin(), rhs.GetSize());
+}
+
+template <typename Type, size_t N, typename Allocator>
+inline bool operator<=(const SmallSimpleVector<Type, N, Allocator>& lhs, const SmallSimpleVector<Type, N, Allocator>& rhs) {
+    return !(rhs < lhs);
+}
+
+template <typename Type, size_t N, typename Allocator>
+inline bool operator>(const SmallSimpleVector<Type, N, Allocator>& lhs, const SmallSimpleVector<Type, N, Allocator>& rhs) {
+    return rhs < lhs;
+}
+
+template <typename Type, size_t N, typename Allocator>
+inline bool operator>=(const SmallSimpleVector<Type, N, Allocator>& lhs, const SmallSimpleVector<Type, N, Allocator>& rhs) {
+    return !(lhs < rhs);
+}
@@ -0,0 +1,533 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <compare>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <span>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "allocator.h"
+#include "array_ptr.h"
+#include "growth_policy.h"
+#include "parallel.h"
+#include "relocation.h"
+
+// Вектор записей из полей Ts..., хранящий каждое поле отдельным непрерывным столбцом.
+// Все столбцы лежат в одном блоке памяти и растут вместе; начало каждого столбца выровнено
+// по kColumnAlignment байт, чтобы столбцы можно было обрабатывать векторными инструкциями.
+// Строка доступна через прокси: кортеж ссылок на поля std::tuple<Ts&...>.
+// Поля переносятся между блоками перемещением, поэтому оно не должно выбрасывать исключений
+template <typename... Ts>
+class SoaSimpleVector {
+public:
+    static_assert(sizeof...(Ts) > 0, "at least one column is required");
+    static_assert((std::is_nothrow_move_constructible_v<Ts> && ...), "columns are relocated without exceptions");
+
+    static constexpr size_t kColumnCount = sizeof...(Ts);
+    static constexpr size_t kColumnAlignment = 64;
+
+    static_assert(((alignof(Ts) <= kColumnAlignment) && ...), "column alignment is limited by kColumnAlignment");
+
+    using Value = std::tuple<Ts...>;
+    using Reference = std::tuple<Ts&...>;
+    using ConstReference = std::tuple<const Ts&...>;
+
+    template <size_t Column>
+    using ColumnType = std::tuple_element_t<Column, Value>;
+
+    // Итератор по строкам; разыменование возвращает кортеж ссылок на поля строки
+    template <bool Const>
+    class RowIterator {
+    public:
+        using Owner = std::conditional_t<Const, const SoaSimpleVector, SoaSimpleVector>;
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = Value;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::conditional_t<Const, ConstReference, Reference>;
+        using pointer = void;
+
+        RowIterator() noexcept = default;
+
+        RowIterator(Owner* owner, size_t index) noexcept
+            : owner_(owner)
+            , index_(index) {
+        }
+
+        // Неконстантный итератор неявно приводится к константному
+        operator RowIterator<true>() const noexcept {
+            return RowIterator<true>(owner_, index_);
+        }
+
+        size_t GetIndex() const noexcept {
+            return index_;
+        }
+
+        reference operator*() const noexcept {
+            return (*owner_)[index_];
+        }
+
+        reference operator[](difference_type offset) const noexcept {
+            return (*owner_)[index_ + offset];
+        }
+
+        RowIterator& operator++() noexcept {
+            ++index_;
+            return *this;
+        }
+
+        RowIterator operator++(int) noexcept {
+            RowIterator copy = *this;
+            ++index_;
+            return copy;
+        }
+
+        RowIterator& operator--() noexcept {
+            --index_;
+            return *this;
+        }
+
+        RowIterator operator--(int) noexcept {
+            RowIterator copy = *this;
+            --index_;
+            return copy;
+        }
+
+        RowIterator& operator+=(difference_type offset) noexcept {
+            index_ += offset;
+            return *this;
+        }
+
+        RowIterator& operator-=(difference_type offset) noexcept {
+            index_ -= offset;
+            return *this;
+        }
+
+        friend RowIterator operator+(RowIterator it, difference_type offset) noexcept {
+            return it += offset;
+        }
+
+        friend RowIterator operator+(difference_type offset, RowIterator it) noexcept {
+            return it += offset;
+        }
+
+        friend RowIterator operator-(RowIterator it, difference_type offset) noexcept {
+            return it -= offset;
+        }
+
+        friend difference_type operator-(const RowIterator& lhs, const RowIterator& rhs) noexcept {
+            return static_cast<difference_type>(lhs.index_) - static_cast<difference_type>(rhs.index_);
+        }
+
+        friend bool operator==(const RowIterator& lhs, const RowIterator& rhs) noexcept {
+            return lhs.index_ == rhs.index_;
+        }
+
+        friend auto operator<=>(const RowIterator& lhs, const RowIterator& rhs) noexcept {
+            return lhs.index_ <=> rhs.index_;
+        }
+
+    private:
+        Owner* owner_ = nullptr;
+        size_t index_ = 0;
+    };
+
+    using Iterator = RowIterator<false>;
+    using ConstIterator = RowIterator<true>;
+
+    SoaSimpleVector() noexcept = default;
+
+    // Создаёт вектор из size строк, поля которых инициализированы значением по умолчанию
+    explicit SoaSimpleVector(size_t size) {
+        Resize(size);
+    }
+
+    SoaSimpleVector(std::initializer_list<Value> init) {
+        Reserve(init.size());
+        for (const Value& row : init) {
+            EmplaceRow(row);
+        }
+    }
+
+    SoaSimpleVector(const SoaSimpleVector& other) {
+        Relocation(other.size_);
+        ConstructColumns([&](auto column) {
+            auto* dest = std::get<decltype(column)::value>(columns_);
+            auto* src = std::get<decltype(column)::value>(other.columns_);
+            std::uninitialized_copy_n(src, other.size_, dest);
+        }, [&](auto column) {
+            std::destroy_n(std::get<decltype(column)::value>(columns_), other.size_);
+        });
+        size_ = other.size_;
+    }
+
+    SoaSimpleVector(SoaSimpleVector&& other) noexcept
+        : storage_(std::move(other.storage_))
+        , columns_(std::exchange(other.columns_, {}))
+        , size_(std::exchange(other.size_, 0))
+        , capacity_(std::exchange(other.capacity_, 0)) {
+    }
+
+    SoaSimpleVector& operator=(const SoaSimpleVector& rhs) {
+        if (this != &rhs) {
+            SoaSimpleVector copy(rhs);
+            swap(copy);
+        }
+        return *this;
+    }
+
+    SoaSimpleVector& operator=(SoaSimpleVector&& rhs) noexcept {
+        if (this != &rhs) {
+            SoaSimpleVector moved(std::move(rhs));
+            swap(moved);
+        }
+        return *this;
+    }
+
+    ~SoaSimpleVector() {
+        Clear();
+    }
+
+    size_t GetSize() const noexcept {
+        return size_;
+    }
+
+    size_t GetCapacity() const noexcept {
+        return capacity_;
+    }
+
+    bool IsEmpty() const noexcept {
+        return size_ == 0;
+    }
+
+    // Непрерывный столбец поля Column, например для векторизованного прохода
+    template <size_t Column>
+    std::span<ColumnType<Column>> GetColumn() noexcept {
+        return {std::get<Column>(columns_), size_};
+    }
+
+    template <size_t Column>
+    std::span<const ColumnType<Column>> GetColumn() const noexcept {
+        return {std::get<Column>(columns_), size_};
+    }
+
+    // Поле Column строки index
+    template <size_t Column>
+    ColumnType<Column>& Get(size_t index) noexcept {
+        assert(index < size_);
+        return std::get<Column>(columns_)[index];
+    }
+
+    template <size_t Column>
+    const ColumnType<Column>& Get(size_t index) const noexcept {
+        assert(index < size_);
+        return std::get<Column>(columns_)[index];
+    }
+
+    Reference operator[](size_t index) noexcept {
+        assert(index < size_);
+        return std::apply([index](Ts*... columns) {
+            return Reference(columns[index]...);
+        }, columns_);
+    }
+
+    ConstReference operator[](size_t index) const noexcept {
+        assert(index < size_);
+        return std::apply([index](Ts*... columns) {
+            return ConstReference(columns[index]...);
+        }, columns_);
+    }
+
+    // Выбрасывает исключение std::out_of_range, если index >= size
+    Reference At(size_t index) {
+        if (index >= size_) {
+            throw std::out_of_range("out_of_range");
+        }
+        return (*this)[index];
+    }
+
+    ConstReference At(size_t index) const {
+        if (index >= size_) {
+            throw std::out_of_range("out_of_range");
+        }
+        return (*this)[index];
+    }
+
+    // Увеличивает вместимость до new_capacity строк, перенося все столбцы в новый блок
+    void Reserve(size_t new_capacity) {
+        if (new_capacity > capacity_) {
+            Relocation(new_capacity);
+        }
+    }
+
+    void ShrinkToFit() {
+        if (capacity_ > size_) {
+            Relocation(size_);
+        }
+    }
+
+    void Clear() noexcept {
+        ForEachColumn([this](auto* column) {
+            std::destroy_n(column, size_);
+        });
+        size_ = 0;
+    }
+
+    // Изменяет размер вектора; новые строки получают значения полей по умолчанию
+    void Resize(size_t new_size) {
+        if (new_size > capacity_) {
+            Relocation(DoublingGrowth::NextCapacity(capacity_, new_size, RowBytes()));
+        }
+        if (new_size > size_) {
+            ConstructColumns([&](auto column) {
+                auto* data = std::get<decltype(column)::value>(columns_);
+                std::uninitialized_value_construct(data + size_, data + new_size);
+            }, [&](auto column) {
+                auto* data = std::get<decltype(column)::value>(columns_);
+                std::destroy(data + size_, data + new_size);
+            });
+        }
+        else {
+            ForEachColumn([&](auto* column) {
+                std::destroy(column + new_size, column + size_);
+            });
+        }
+        size_ = new_size;
+    }
+
+    void PushBack(const Ts&... values) {
+        EmplaceRow(Value(values...));
+    }
+
+    void PushBack(Ts&&... values) {
+        EmplaceRow(Value(std::move(values)...));
+    }
+
+    // Добавляет строку, конструируя поле k из args[k]
+    template <typename... Args>
+        requires(sizeof...(Args) == kColumnCount)
+    Reference EmplaceBack(Args&&... args) {
+        EmplaceRow(Value(std::forward<Args>(args)...));
+        return (*this)[size_ - 1];
+    }
+
+    Iterator Insert(ConstIterator pos, const Ts&... values) {
+        return InsertRow(pos.GetIndex(), Value(values...));
+    }
+
+    Iterator Insert(ConstIterator pos, Ts&&... values) {
+        return InsertRow(pos.GetIndex(), Value(std::move(values)...));
+    }
+
+    void PopBack() noexcept {
+        assert(!IsEmpty());
+        --size_;
+        ForEachColumn([this](auto* column) {
+            std::destroy_at(column + size_);
+        });
+    }
+
+    Iterator Erase(ConstIterator pos) {
+        assert(pos.GetIndex() < size_);
+        return Erase(pos, pos + 1);
+    }
+
+    // Удаляет строки [first, last) одним сдвигом хвоста каждого столбца
+    Iterator Erase(ConstIterator first, ConstIterator last) {
+        const size_t from = first.GetIndex();
+        const size_t count = last.GetIndex() - from;
+        assert(from <= last.GetIndex() && last.GetIndex() <= size_);
+        ForEachColumn([&](auto* column) {
+            std::destroy_n(column + from, count);
+            ShiftElements(column, from + count, size_ - from - count, from);
+        });
+        size_ -= count;
+        return Iterator(this, from);
+    }
+
+    void swap(SoaSimpleVector& other) noexcept {
+        storage_.swap(other.storage_);
+        std::swap(columns_, other.columns_);
+        std::swap(size_, other.size_);
+        std::swap(capacity_, other.capacity_);
+    }
+
+    Iterator begin() noexcept {
+        return Iterator(this, 0);
+    }
+
+    Iterator end() noexcept {
+        return Iterator(this, size_);
+    }
+
+    ConstIterator begin() const noexcept {
+        return ConstIterator(this, 0);
+    }
+
+    ConstIterator end() const noexcept {
+        return ConstIterator(this, size_);
+    }
+
+    ConstIterator cbegin() const noexcept {
+        return begin();
+    }
+
+    ConstIterator cend() const noexcept {
+        return end();
+    }
+
+private:
+    // Единица выделения памяти: блок выровнен по kColumnAlignment
+    struct alignas(kColumnAlignment) ColumnBlock {
+        std::byte bytes[kColumnAlignment];
+    };
+
+    static constexpr std::array<size_t, kColumnCount> kColumnSizes = {sizeof(Ts)...};
+
+    ArrayPtr<ColumnBlock> storage_{MallocAllocator<ColumnBlock>()};
+    std::tuple<Ts*...> columns_{};
+    size_t size_ = 0;
+    size_t capacity_ = 0;
+
+    static constexpr size_t RowBytes() noexcept {
+        return (sizeof(Ts) + ...);
+    }
+
+    // Сколько блоков занимает столбец из capacity элементов размером element_size
+    static size_t ColumnBlocks(size_t capacity, size_t element_size) {
+        if (capacity > (static_cast<size_t>(-1) - kColumnAlignment) / element_size / kColumnCount) {
+            throw std::length_error("SoaSimpleVector is too large");
+        }
+        return (capacity * element_size + kColumnAlignment - 1) / kColumnAlignment;
+    }
+
+    // Вызывает body(column) для указателя на начало каждого столбца
+    template <typename Body>
+    void ForEachColumn(const Body& body) {
+        std::apply([&body](auto*... columns) {
+            (body(columns), ...);
+        }, columns_);
+    }
+
+    // Вызывает construct(column) для каждого номера столбца (std::integral_constant).
+    // Если конструирование столбца выбросило исключение, уже заполненные столбцы очищаются через destroy(column)
+    template <typename Construct, typename Destroy>
+    static void ConstructColumns(const Construct& construct, const Destroy& destroy) {
+        ConstructColumns(construct, destroy, std::index_sequence_for<Ts...>{});
+    }
+
+    template <typename Construct, typename Destroy, size_t... Columns>
+    static void ConstructColumns(const Construct& construct, const Destroy& destroy, std::index_sequence<Columns...>) {
+        size_t done = 0;
+        try {
+            ((construct(std::integral_constant<size_t, Columns>{}), ++done), ...);
+        }
+        catch (...) {
+            ((Columns < done ? destroy(std::integral_constant<size_t, Columns>{}) : void()), ...);
+            throw;
+        }
+    }
+
+    // Размещает столбцы вместимостью capacity в блоке storage
+    static std::tuple<Ts*...> LayoutColumns(ColumnBlock* storage, size_t capacity) noexcept {
+        std::tuple<Ts*...> columns;
+        size_t offset = 0;
+        std::apply([&](auto*&... column) {
+            ((column = reinterpret_cast<std::remove_reference_t<decltype(column)>>(storage + offset),
+                offset += ColumnBlocks(capacity, sizeof(*column))), ...);
+        }, columns);
+        return columns;
+    }
+
+    // Переносит столбцы в новый блок вместимостью new_capacity строк
+    void Relocation(size_t new_capacity) {
+        size_t blocks = 0;
+        for (size_t element_size : kColumnSizes) {
+            blocks += ColumnBlocks(new_capacity, element_size);
+        }
+        ArrayPtr<ColumnBlock> new_storage(blocks, RawMemoryTag{});
+        std::tuple<Ts*...> new_columns = LayoutColumns(new_storage.Get(), new_capacity);
+        RelocateColumns(new_columns, std::index_sequence_for<Ts...>{});
+        storage_.swap(new_storage);
+        columns_ = new_columns;
+        capacity_ = new_capacity;
+    }
+
+    template <size_t... Columns>
+    void RelocateColumns(const std::tuple<Ts*...>& new_columns, std::index_sequence<Columns...>) noexcept {
+        (UninitializedRelocate(std::get<Columns>(columns_), size_, std::get<Columns>(new_columns)), ...);
+    }
+
+    // Переносит поля готовой строки в конец столбцов
+    void EmplaceRow(Value&& row) {
+        if (size_ == capacity_) {
+            Relocation(DoublingGrowth::NextCapacity(capacity_, size_ + 1, RowBytes()));
+        }
+        MoveRowTo(size_, std::move(row), std::index_sequence_for<Ts...>{});
+        ++size_;
+    }
+
+    void EmplaceRow(const Value& row) {
+        EmplaceRow(Value(row));
+    }
+
+    // Строка конструируется до сдвига столбцов: значения могут ссылаться на элементы этого вектора
+    Iterator InsertRow(size_t index, Value&& row) {
+        assert(index <= size_);
+        if (size_ == capacity_) {
+            Relocation(DoublingGrowth::NextCapacity(capacity_, size_ + 1, RowBytes()));
+        }
+        ForEachColumn([&](auto* column) {
+            ShiftElements(column, index, size_ - index, index + 1);
+        });
+        MoveRowTo(index, std::move(row), std::index_sequence_for<Ts...>{});
+        ++size_;
+        return Iterator(this, index);
+    }
+
+    // Переносит count элементов столбца с позиции from на позицию to; диапазоны могут перекрываться.
+    // Позиции [to, to + count), не занятые исходным диапазоном, должны быть сырой памятью
+    template <typename Type>
+    static void ShiftElements(Type* column, size_t from, size_t count, size_t to) noexcept {
+        if constexpr (is_trivially_relocatable_v<Type>) {
+            RelocateBytes(column + from, count, column + to);
+        }
+        else if (to < from) {
+            for (size_t i = 0; i < count; ++i) {
+                UninitializedRelocate(column + from + i, 1, column + to + i);
+            }
+        }
+        else {
+            for (size_t i = count; i > 0; --i) {
+                UninitializedRelocate(column + from + i - 1, 1, column + to + i - 1);
+            }
+        }
+    }
+
+    template <size_t... Columns>
+    void MoveRowTo(size_t index, Value&& row, std::index_sequence<Columns...>) noexcept {
+        (new (std::get<Columns>(columns_) + index) Ts(std::get<Columns>(std::move(row))), ...);
+    }
+};
+
+template <typename... Ts>
+bool operator==(const SoaSimpleVector<Ts...>& lhs, const SoaSimpleVector<Ts...>& rhs) {
+    if (lhs.GetSize() != rhs.GetSize()) {
+        return false;
+    }
+    return [&]<size_t... Columns>(std::index_sequence<Columns...>) {
+        return (ParallelEqual(lhs.template GetColumn<Columns>().data(), rhs.template GetColumn<Columns>().data(), lhs.GetSize()) && ...);
+    }(std::index_sequence_for<Ts...>{});
+}
+
+template <typename... Ts>
+bool operator!=(const SoaSimpleVector<Ts...>& lhs, const SoaSimpleVector<Ts...>& rhs) {
+    return !(lhs == rhs);
+}
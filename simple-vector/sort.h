@@ -0,0 +1,211 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <ranges>
+#include <type_traits>
+#include <vector>
+
+#include "allocator.h"
+#include "array_ptr.h"
+#include "parallel.h"
+
+// Сортировка непрерывных последовательностей: SimpleVector, SimpleDevector, std::span.
+// Целые числа и числа с плавающей точкой со сравнением по возрастанию или убыванию сортируются
+// поразрядно (LSD radix sort, по байту за проход), остальные — слиянием частей, отсортированных
+// std::sort или std::stable_sort. В параллельном режиме (ParallelExecution::Enable) части
+// сортируются и сливаются в потоках пула, а поразрядная сортировка делит между ними подсчёт и раскладку
+
+// Меньшие массивы сортируются std::sort: проходы по 256 корзинам на них не окупаются
+inline constexpr size_t kRadixSortMinSize = 1024;
+
+// Типы, которые можно сортировать поразрядно: ключ — беззнаковое целое той же ширины
+template <typename Type>
+inline constexpr bool is_radix_sortable_v = (std::is_integral_v<Type> && !std::is_same_v<Type, bool> && sizeof(Type) <= 8)
+    || (std::is_floating_point_v<Type> && std::numeric_limits<Type>::is_iec559 && (sizeof(Type) == 4 || sizeof(Type) == 8));
+
+// Сравнения, порядок которых совпадает с порядком ключей поразрядной сортировки (или обратен ему)
+template <typename Compare, typename Type>
+inline constexpr bool is_ascending_compare_v = std::is_same_v<Compare, std::less<>> || std::is_same_v<Compare, std::less<Type>>
+    || std::is_same_v<Compare, std::ranges::less>;
+
+template <typename Compare, typename Type>
+inline constexpr bool is_descending_compare_v = std::is_same_v<Compare, std::greater<>> || std::is_same_v<Compare, std::greater<Type>>
+    || std::is_same_v<Compare, std::ranges::greater>;
+
+// Беззнаковый ключ, порядок которого совпадает с порядком значений: у целых со знаком инвертируется
+// знаковый бит, у чисел с плавающей точкой отрицательные инвертируются целиком.
+// -0.0 и 0.0 равны для std::less и получают один ключ, поэтому устойчивость сохраняется;
+// NaN ставятся по краям, в зависимости от знака
+template <bool Descending, typename Type>
+auto RadixKey(Type value) noexcept {
+    if constexpr (std::is_floating_point_v<Type>) {
+        using Bits = std::conditional_t<sizeof(Type) == 4, uint32_t, uint64_t>;
+        constexpr Bits kSign = Bits{1} << (sizeof(Bits) * 8 - 1);
+        const Bits bits = std::bit_cast<Bits>(value == Type{0} ? Type{0} : value);
+        const Bits key = (bits & kSign) != 0 ? static_cast<Bits>(~bits) : static_cast<Bits>(bits | kSign);
+        return Descending ? static_cast<Bits>(~key) : key;
+    }
+    else {
+        using Bits = std::make_unsigned_t<Type>;
+        constexpr Bits kSign = std::is_signed_v<Type> ? Bits{1} << (sizeof(Bits) * 8 - 1) : Bits{0};
+        const Bits key = static_cast<Bits>(static_cast<Bits>(value) ^ kSign);
+        return Descending ? static_cast<Bits>(~key) : key;
+    }
+}
+
+template <bool Descending, typename Type>
+size_t RadixDigit(Type value, size_t digit) noexcept {
+    return static_cast<size_t>(RadixKey<Descending>(value) >> (digit * 8)) & 0xFF;
+}
+
+using RadixHistogram = std::array<size_t, 256>;
+
+// Поразрядная сортировка: сначала один проход считает корзины всех байтов ключа, затем каждый байт,
+// по которому элементы различаются, раскладывается из текущего буфера в другой. Раскладка устойчива.
+// При нескольких частях каждая часть заново считает свои корзины текущего байта и пишет
+// в свои заранее вычисленные позиции, так что результат не зависит от числа частей
+template <bool Descending, typename Type>
+void RadixSort(Type* data, size_t count, ThreadPool* pool, size_t chunks) {
+    constexpr size_t kDigits = sizeof(Type);
+    const size_t chunk_size = (count + chunks - 1) / chunks;
+    auto chunk_begin = [count, chunk_size](size_t chunk) {
+        return std::min(count, chunk * chunk_size);
+    };
+
+    std::vector<std::array<RadixHistogram, kDigits>> partial(chunks);
+    RunChunks(pool, chunks, [&](size_t chunk) {
+        std::array<RadixHistogram, kDigits>& histograms = partial[chunk];
+        for (RadixHistogram& histogram : histograms) {
+            histogram.fill(0);
+        }
+        for (size_t i = chunk_begin(chunk); i < chunk_begin(chunk + 1); ++i) {
+            const auto key = RadixKey<Descending>(data[i]);
+            for (size_t digit = 0; digit < kDigits; ++digit) {
+                ++histograms[digit][static_cast<size_t>(key >> (digit * 8)) & 0xFF];
+            }
+        }
+    });
+    std::array<RadixHistogram, kDigits> totals = partial[0];
+    for (size_t chunk = 1; chunk < chunks; ++chunk) {
+        for (size_t digit = 0; digit < kDigits; ++digit) {
+            for (size_t bucket = 0; bucket < 256; ++bucket) {
+                totals[digit][bucket] += partial[chunk][digit][bucket];
+            }
+        }
+    }
+
+    ArrayPtr<Type> buffer(count, RawMemoryTag{});
+    Type* from = data;
+    Type* to = buffer.Get();
+    std::vector<RadixHistogram> positions(chunks);
+    for (size_t digit = 0; digit < kDigits; ++digit) {
+        // Все элементы в одной корзине: байт не меняет порядка
+        if (totals[digit][RadixDigit<Descending>(from[0], digit)] == count) {
+            continue;
+        }
+        if (chunks == 1) {
+            positions[0] = totals[digit];
+        }
+        else {
+            RunChunks(pool, chunks, [&](size_t chunk) {
+                RadixHistogram& histogram = positions[chunk];
+                histogram.fill(0);
+                for (size_t i = chunk_begin(chunk); i < chunk_begin(chunk + 1); ++i) {
+                    ++histogram[RadixDigit<Descending>(from[i], digit)];
+                }
+            });
+        }
+        // Корзина b части c начинается после всех меньших корзин и после корзины b предыдущих частей
+        size_t offset = 0;
+        for (size_t bucket = 0; bucket < 256; ++bucket) {
+            for (size_t chunk = 0; chunk < chunks; ++chunk) {
+                const size_t size = positions[chunk][bucket];
+                positions[chunk][bucket] = offset;
+                offset += size;
+            }
+        }
+        RunChunks(pool, chunks, [&](size_t chunk) {
+            RadixHistogram& next = positions[chunk];
+            for (size_t i = chunk_begin(chunk); i < chunk_begin(chunk + 1); ++i) {
+                to[next[RadixDigit<Descending>(from[i], digit)]++] = from[i];
+            }
+        });
+        std::swap(from, to);
+    }
+    if (from != data) {
+        std::memcpy(static_cast<void*>(data), static_cast<const void*>(from), count * sizeof(Type));
+    }
+}
+
+// Сортирует части в потоках пула и сливает соседние пары частей, удваивая их размер на каждом шаге
+template <bool Stable, typename Type, typename Compare>
+void MergeSortChunks(Type* data, size_t count, Compare& comp, ThreadPool* pool, size_t chunks) {
+    const size_t chunk_size = (count + chunks - 1) / chunks;
+    auto chunk_begin = [count, chunk_size](size_t chunk) {
+        return std::min(count, chunk * chunk_size);
+    };
+    RunChunks(pool, chunks, [&](size_t chunk) {
+        if constexpr (Stable) {
+            std::stable_sort(data + chunk_begin(chunk), data + chunk_begin(chunk + 1), comp);
+        }
+        else {
+            std::sort(data + chunk_begin(chunk), data + chunk_begin(chunk + 1), comp);
+        }
+    });
+    for (size_t width = 1; width < chunks; width *= 2) {
+        const size_t pairs = (chunks + 2 * width - 1) / (2 * width);
+        RunChunks(pool, pairs, [&](size_t pair) {
+            const size_t first = pair * 2 * width;
+            Type* middle = data + chunk_begin(std::min(chunks, first + width));
+            std::inplace_merge(data + chunk_begin(first), middle, data + chunk_begin(std::min(chunks, first + 2 * width)), comp);
+        });
+    }
+}
+
+template <bool Stable, typename Type, typename Compare>
+void SortContiguous(Type* data, size_t count, Compare& comp) {
+    if (count < 2) {
+        return;
+    }
+    std::shared_ptr<ThreadPool> pool = ParallelExecution::PoolFor(count * sizeof(Type));
+    const size_t chunks = pool ? ParallelChunkCount(*pool, count, sizeof(Type)) : 1;
+    if constexpr (is_radix_sortable_v<Type> && (is_ascending_compare_v<Compare, Type> || is_descending_compare_v<Compare, Type>)) {
+        if (count >= kRadixSortMinSize) {
+            RadixSort<is_descending_compare_v<Compare, Type>>(data, count, pool.get(), chunks);
+            return;
+        }
+    }
+    if (chunks == 1) {
+        if constexpr (Stable) {
+            std::stable_sort(data, data + count, comp);
+        }
+        else {
+            std::sort(data, data + count, comp);
+        }
+        return;
+    }
+    MergeSortChunks<Stable>(data, count, comp, pool.get(), chunks);
+}
+
+// Сортирует элементы непрерывной последовательности в порядке comp
+template <std::ranges::contiguous_range Range, typename Compare = std::less<>>
+    requires std::ranges::sized_range<Range>
+void Sort(Range&& range, Compare comp = Compare()) {
+    SortContiguous<false>(std::ranges::data(range), std::ranges::size(range), comp);
+}
+
+// Сортирует, сохраняя относительный порядок эквивалентных элементов
+template <std::ranges::contiguous_range Range, typename Compare = std::less<>>
+    requires std::ranges::sized_range<Range>
+void StableSort(Range&& range, Compare comp = Compare()) {
+    SortContiguous<true>(std::ranges::data(range), std::ranges::size(range), comp);
+}
@@ -0,0 +1,255 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+#if __has_include(<cxxabi.h>)
+#include <cxxabi.h>
+#endif
+
+// Статистика выделений и переносов памяти векторов.
+// Включается макросом SIMPLE_VECTOR_STATS (опция CMake SIMPLE_VECTOR_STATS);
+// без него все точки сбора пусты и компилятор их удаляет
+#ifdef SIMPLE_VECTOR_STATS
+inline constexpr bool kVectorStatsEnabled = true;
+#else
+inline constexpr bool kVectorStatsEnabled = false;
+#endif
+
+// Место, где вектору пришлось перенести элементы в новую память
+enum class RelocationSite {
+    kReserve,   // Reserve, Resize, ShrinkToFit
+    kPushBack,  // PushBack, EmplaceBack, PushFront
+    kInsert,    // Insert, Emplace
+};
+
+inline constexpr size_t kRelocationSiteCount = 3;
+
+// Гистограмма размеров при разрушении: корзина 0 — пустые векторы,
+// корзина k — размеры из [2^(k-1), 2^k)
+inline constexpr size_t kSizeHistogramBuckets = 65;
+
+// Снимок счётчиков одного типа вектора
+struct VectorStatsSnapshot {
+    std::string type_name;
+    uint64_t allocations = 0;
+    uint64_t bytes_allocated = 0;
+    std::array<uint64_t, kRelocationSiteCount> relocations{};
+    uint64_t elements_moved = 0;
+    uint64_t elements_copied = 0;
+    uint64_t peak_capacity = 0;
+    std::array<uint64_t, kSizeHistogramBuckets> destroyed_sizes{};
+
+    uint64_t GetRelocations(RelocationSite site) const {
+        return relocations[static_cast<size_t>(site)];
+    }
+
+    uint64_t GetTotalRelocations() const {
+        return relocations[0] + relocations[1] + relocations[2];
+    }
+};
+
+// Счётчики одного типа вектора; обновляются из любых потоков
+struct VectorStatsCounters {
+    std::atomic<uint64_t> allocations{0};
+    std::atomic<uint64_t> bytes_allocated{0};
+    std::array<std::atomic<uint64_t>, kRelocationSiteCount> relocations{};
+    std::atomic<uint64_t> elements_moved{0};
+    std::atomic<uint64_t> elements_copied{0};
+    std::atomic<uint64_t> peak_capacity{0};
+    std::array<std::atomic<uint64_t>, kSizeHistogramBuckets> destroyed_sizes{};
+
+    VectorStatsSnapshot Snapshot(std::string type_name) const {
+        VectorStatsSnapshot snapshot;
+        snapshot.type_name = std::move(type_name);
+        snapshot.allocations = allocations.load(std::memory_order_relaxed);
+        snapshot.bytes_allocated = bytes_allocated.load(std::memory_order_relaxed);
+        for (size_t i = 0; i < kRelocationSiteCount; ++i) {
+            snapshot.relocations[i] = relocations[i].load(std::memory_order_relaxed);
+        }
+        snapshot.elements_moved = elements_moved.load(std::memory_order_relaxed);
+        snapshot.elements_copied = elements_copied.load(std::memory_order_relaxed);
+        snapshot.peak_capacity = peak_capacity.load(std::memory_order_relaxed);
+        for (size_t i = 0; i < kSizeHistogramBuckets; ++i) {
+            snapshot.destroyed_sizes[i] = destroyed_sizes[i].load(std::memory_order_relaxed);
+        }
+        return snapshot;
+    }
+
+    void Reset() {
+        allocations = 0;
+        bytes_allocated = 0;
+        for (auto& counter : relocations) {
+            counter = 0;
+        }
+        elements_moved = 0;
+        elements_copied = 0;
+        peak_capacity = 0;
+        for (auto& counter : destroyed_sizes) {
+            counter = 0;
+        }
+    }
+};
+
+// Реестр счётчиков всех типов векторов, встретившихся в программе
+class VectorStatsRegistry {
+public:
+    static VectorStatsRegistry& Instance() {
+        // Реестр не разрушается: векторы в статических объектах обращаются к нему и при выходе
+        static VectorStatsRegistry* registry = new VectorStatsRegistry();
+        return *registry;
+    }
+
+    void Register(std::string type_name, VectorStatsCounters* counters) {
+        std::lock_guard guard(mutex_);
+        entries_.push_back({std::move(type_name), counters});
+    }
+
+    std::vector<VectorStatsSnapshot> Snapshot() const {
+        std::lock_guard guard(mutex_);
+        std::vector<VectorStatsSnapshot> result;
+        for (const Entry& entry : entries_) {
+            result.push_back(entry.counters->Snapshot(entry.type_name));
+        }
+        return result;
+    }
+
+    void Reset() {
+        std::lock_guard guard(mutex_);
+        for (const Entry& entry : entries_) {
+            entry.counters->Reset();
+        }
+    }
+
+private:
+    struct Entry {
+        std::string type_name;
+        VectorStatsCounters* counters;
+    };
+
+    mutable std::mutex mutex_;
+    std::vector<Entry> entries_;
+};
+
+// Читаемое имя типа
+inline std::string DemangleTypeName(const char* name) {
+#if __has_include(<cxxabi.h>)
+    int status = 0;
+    std::unique_ptr<char, void (*)(void*)> demangled(abi::__cxa_demangle(name, nullptr, nullptr, &status), std::free);
+    if (status == 0 && demangled) {
+        return demangled.get();
+    }
+#endif
+    return name;
+}
+
+// Точки сбора статистики для типа вектора Vector
+template <typename Vector>
+class VectorStats {
+public:
+    static void OnAllocate(size_t capacity, size_t bytes) noexcept {
+        if constexpr (kVectorStatsEnabled) {
+            VectorStatsCounters& counters = Counters();
+            counters.allocations.fetch_add(1, std::memory_order_relaxed);
+            counters.bytes_allocated.fetch_add(bytes, std::memory_order_relaxed);
+            uint64_t peak = counters.peak_capacity.load(std::memory_order_relaxed);
+            while (peak < capacity && !counters.peak_capacity.compare_exchange_weak(peak, capacity, std::memory_order_relaxed)) {
+            }
+        }
+    }
+
+    static void OnRelocate([[maybe_unused]] RelocationSite site, [[maybe_unused]] size_t count, [[maybe_unused]] bool by_copy) noexcept {
+        if constexpr (kVectorStatsEnabled) {
+            if (count == 0) {
+                return;
+            }
+            VectorStatsCounters& counters = Counters();
+            counters.relocations[static_cast<size_t>(site)].fetch_add(1, std::memory_order_relaxed);
+            (by_copy ? counters.elements_copied : counters.elements_moved).fetch_add(count, std::memory_order_relaxed);
+        }
+    }
+
+    static void OnDestroy([[maybe_unused]] size_t size) noexcept {
+        if constexpr (kVectorStatsEnabled) {
+            size_t bucket = 0;
+            while (bucket < 64 && (size >> bucket) != 0) {
+                ++bucket;
+            }
+            Counters().destroyed_sizes[bucket].fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    // Возвращает снимок счётчиков; без SIMPLE_VECTOR_STATS все счётчики нулевые
+    static VectorStatsSnapshot Get() {
+        if constexpr (kVectorStatsEnabled) {
+            return Counters().Snapshot(TypeName());
+        }
+        else {
+            return VectorStatsSnapshot{};
+        }
+    }
+
+private:
+    static std::string TypeName() {
+        return DemangleTypeName(typeid(Vector).name());
+    }
+
+    static VectorStatsCounters& Counters() noexcept {
+        static VectorStatsCounters counters;
+        static const bool registered = (VectorStatsRegistry::Instance().Register(TypeName(), &counters), true);
+        (void)registered;
+        return counters;
+    }
+};
+
+// Печатает счётчики всех типов векторов, по строке на тип
+inline void DumpVectorStats(std::ostream& out) {
+    if constexpr (!kVectorStatsEnabled) {
+        out << "vector stats are disabled, build with SIMPLE_VECTOR_STATS" << std::endl;
+    }
+    else {
+        for (const VectorStatsSnapshot& stats : VectorStatsRegistry::Instance().Snapshot()) {
+            out << stats.type_name
+                << ": allocations=" << stats.allocations
+                << " bytes=" << stats.bytes_allocated
+                << " relocations(reserve/push_back/insert)=" << stats.relocations[0]
+                << '/' << stats.relocations[1] << '/' << stats.relocations[2]
+                << " moved=" << stats.elements_moved
+                << " copied=" << stats.elements_copied
+                << " peak_capacity=" << stats.peak_capacity
+                << " destroyed_sizes={";
+            bool first = true;
+            for (size_t bucket = 0; bucket < kSizeHistogramBuckets; ++bucket) {
+                if (stats.destroyed_sizes[bucket] == 0) {
+                    continue;
+                }
+                out << (first ? "" : ", ");
+                first = false;
+                if (bucket == 0) {
+                    out << "0";
+                }
+                else {
+                    out << '[' << (uint64_t{1} << (bucket - 1)) << ',' << (bucket == 64 ? "inf" : std::to_string(uint64_t{1} << bucket)) << ')';
+                }
+                out << ": " << stats.destroyed_sizes[bucket];
+            }
+            out << '}' << std::endl;
+        }
+    }
+}
+
+// Обнуляет счётчики всех типов векторов
+inline void ResetVectorStats() {
+    if constexpr (kVectorStatsEnabled) {
+        VectorStatsRegistry::Instance().Reset();
+    }
+}